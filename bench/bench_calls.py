@@ -0,0 +1,68 @@
+"""Per-call cost breakdown of the fd58 wrappers.
+
+For each call, prints the total time per call next to:
+
+  floor    a builtin METH_O call (len) on the same argument, i.e. what the
+           interpreter spends on any C function call in a timeit loop
+  kernel   the bound backend's conversion alone, timed in a C loop
+  wrapper  the rest: argument handling, buffer acquisition, allocating
+           the result and raising, i.e. the cost of the binding itself
+
+Times are the minimum over many short rounds, which is much more stable
+than a long average on a busy machine.
+
+    python bench/bench_calls.py [--backend NAME] [--rounds N]
+"""
+
+import argparse
+import os
+import timeit
+
+import fd58
+
+
+def best(timer, number, rounds):
+    return min(timer.timeit(number) for _ in range(rounds)) / number * 1e9
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--backend", help="backend to bind all ops to (default: autotuned)")
+    parser.add_argument("--rounds", type=int, default=100)
+    parser.add_argument("--number", type=int, default=5000)
+    args = parser.parse_args()
+    if args.backend:
+        fd58.set_backend(args.backend)
+
+    x32, x64 = os.urandom(32), os.urandom(64)
+    e32, e64 = fd58.enc32(x32), fd58.enc64(x64)
+    out = bytearray(128)
+    calls = [
+        ("enc32(bytes)", "enc32", "f(a)", fd58.enc32, x32),
+        ("enc32(bytearray)", "enc32", "f(a)", fd58.enc32, bytearray(x32)),
+        ("enc32_str(bytes)", "enc32", "f(a)", fd58.enc32_str, x32),
+        ("enc32_into(bytes)", "enc32", "f(a, out)", fd58.enc32_into, x32),
+        ("dec32(bytes)", "dec32", "f(a)", fd58.dec32, e32),
+        ("dec32(str)", "dec32", "f(a)", fd58.dec32, e32.decode()),
+        ("dec32(bytearray)", "dec32", "f(a)", fd58.dec32, bytearray(e32)),
+        ("dec32_into(bytes)", "dec32", "f(a, out)", fd58.dec32_into, e32),
+        ("enc64(bytes)", "enc64", "f(a)", fd58.enc64, x64),
+        ("dec64(bytes)", "dec64", "f(a)", fd58.dec64, e64),
+    ]
+
+    print(f"backends: {fd58.backend('enc32')}/{fd58.backend('enc64')}/{fd58.backend('dec32')}/{fd58.backend('dec64')} (enc32/enc64/dec32/dec64), ns per call")
+    print(f"{'call':<20}{'total':>8}{'floor':>8}{'kernel':>8}{'wrapper':>9}")
+    for name, op, stmt, f, a in calls:
+        total = floor = kernel = float("inf")
+        call = timeit.Timer(stmt, globals={"f": f, "a": a, "out": out})
+        base = timeit.Timer("f(a)", globals={"f": len, "a": a})
+        # Interleave the three so that they see the same machine state.
+        for _ in range(args.rounds):
+            total = min(total, best(call, args.number, 1))
+            floor = min(floor, best(base, args.number, 1))
+            kernel = min(kernel, fd58._kernel_time(op, args.number) * 1e9)
+        print(f"{name:<20}{total:8.1f}{floor:8.1f}{kernel:8.1f}{total - floor - kernel:9.1f}")
+
+
+if __name__ == "__main__":
+    main()
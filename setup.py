@@ -22,13 +22,23 @@ def no_cythonize(extensions, **_ignore):
 
 
 extensions = [
-    Extension("fd58", ["src/fd58/fd58.pyx", "src/fd58/fd_base58.c"]),
+    Extension(
+        "fd58",
+        [
+            "src/fd58/fd58.pyx",
+            "src/fd58/fd_base58.c",
+            "src/fd58/fd_base58_avx2.c",
+            "src/fd58/fd_base58_avx512.c",
+            "src/fd58/fd_base58_ifma.c",
+            "src/fd58/fd_base58_wide.c",
+        ],
+    ),
 ]
 
 CYTHONIZE = bool(int(os.getenv("CYTHONIZE", 0))) and cythonize is not None
 
 if CYTHONIZE:
-    compiler_directives = {"language_level": 3, "embedsignature": True}
+    compiler_directives = {"language_level": 3, "embedsignature": True, "binding": False, "freethreading_compatible": True}
     extensions = cythonize(extensions, compiler_directives=compiler_directives)
 else:
     extensions = no_cythonize(extensions)
@@ -1,6 +1,35 @@
 # fd58.pxd
-cdef extern from "fd_base58.h":
+cdef extern from "fd_base58.h" nogil:
+    enum:
+        FD_BASE58_ENCODED_32_LEN
+        FD_BASE58_ENCODED_64_LEN
     char* fd_base58_encode_32(const unsigned char* bytes, unsigned* opt_len, char* out)
     char* fd_base58_encode_64(const unsigned char* bytes, unsigned* opt_len, char* out)
+    unsigned long fd_base58_encoded_len_32(const unsigned char* bytes)
+    unsigned long fd_base58_encoded_len_64(const unsigned char* bytes)
+    unsigned long fd_base58_encoded_len_32_batch(const unsigned char* bytes, unsigned long cnt, unsigned char* opt_len)
+    unsigned long fd_base58_encoded_len_64_batch(const unsigned char* bytes, unsigned long cnt, unsigned char* opt_len)
+    char* fd_base58_encode_32_batch(const unsigned char* bytes, unsigned long cnt, unsigned* opt_len, char* out)
+    char* fd_base58_encode_64_batch(const unsigned char* bytes, unsigned long cnt, unsigned* opt_len, char* out)
+    char* fd_base58_encode_32_packed(const unsigned char* bytes, unsigned long cnt, unsigned char* opt_len, char* out)
+    char* fd_base58_encode_64_packed(const unsigned char* bytes, unsigned long cnt, unsigned char* opt_len, char* out)
     unsigned char* fd_base58_decode_32(const char* encoded, unsigned char* out)
     unsigned char* fd_base58_decode_64(const char* encoded, unsigned char* out)
+    unsigned long fd_base58_decode_32_batch(const char* const* encoded, unsigned long cnt, unsigned char* out, unsigned char* opt_valid)
+    unsigned long fd_base58_decode_64_batch(const char* const* encoded, unsigned long cnt, unsigned char* out, unsigned char* opt_valid)
+    unsigned char* fd_base58_decode_32_len(const char* encoded, unsigned long len, unsigned char* out)
+    unsigned char* fd_base58_decode_64_len(const char* encoded, unsigned long len, unsigned char* out)
+    enum:
+        FD_BASE58_SUCCESS
+        FD_BASE58_ERR_LEN
+        FD_BASE58_ERR_CHAR
+        FD_BASE58_ERR_OVERFLOW
+        FD_BASE58_ERR_LEADING_ONES
+    int fd_base58_decode_32_ex(const char* encoded, unsigned long len, unsigned char* out, unsigned long* opt_err_off)
+    int fd_base58_decode_64_ex(const char* encoded, unsigned long len, unsigned char* out, unsigned long* opt_err_off)
+    const char* fd_base58_strerror(int err)
+    unsigned long fd_base58_decode_32_packed(const char* slots, const unsigned char* opt_len, unsigned long cnt, unsigned char* out, signed char* opt_err)
+    unsigned long fd_base58_decode_64_packed(const char* slots, const unsigned char* opt_len, unsigned long cnt, unsigned char* out, signed char* opt_err)
+    const char* fd_base58_backend_name(unsigned long idx)
+    const char* fd_base58_backend(int op)
+    int fd_base58_set_backend(const char* name, int op)
@@ -1,35 +1,1292 @@
 cimport fd58
+from cpython cimport array
+from cpython.buffer cimport PyBUF_C_CONTIGUOUS, PyBUF_FORMAT, PyBUF_SIMPLE, PyBUF_WRITABLE, PyBuffer_FillInfo, PyBuffer_Release, PyObject_GetBuffer
+from cpython.mem cimport PyMem_Free, PyMem_Malloc
+from cpython.pycapsule cimport PyCapsule_Destructor, PyCapsule_GetPointer, PyCapsule_New
+from cpython.ref cimport Py_DECREF, Py_INCREF
+from cpython.bytes cimport PyBytes_AS_STRING, PyBytes_CheckExact, PyBytes_FromStringAndSize, PyBytes_GET_SIZE
+from cpython.unicode cimport PyUnicode_AsUTF8AndSize, PyUnicode_Check, PyUnicode_DATA, PyUnicode_GET_LENGTH, PyUnicode_New
+from libc.stdint cimport int32_t, int64_t, uint8_t
+from libc.stdlib cimport free, malloc
+from libc.string cimport memcpy, memset
 
-cpdef enc32(bytes data):
+cdef extern from "<string.h>" nogil:
+    size_t strnlen(const char* s, size_t maxlen)
+
+import array
+import json
+import os
+import threading
+import time
+import warnings
+
+# Whether the conversions release the GIL around the kernels (see
+# set_release_gil).  Inputs and outputs are pinned while it is released:
+# bytes and str are immutable, and other objects have an exported buffer
+# that stops them from being resized.
+cdef bint _release_gil = False
+
+cdef extern from "Python.h":
+    ctypedef struct PyThreadState:
+        pass
+    PyThreadState* PyEval_SaveThread() nogil
+    void PyEval_RestoreThread(PyThreadState* tstate) nogil
+
+cdef inline PyThreadState* _unlock() noexcept:
+    return PyEval_SaveThread() if _release_gil else NULL
+
+cdef inline PyThreadState* _unlock_bulk(Py_ssize_t cnt) noexcept:
+    # The bulk conversions release the GIL whenever they have enough
+    # items to amortize it, even with set_release_gil(False) (which
+    # documents this).
+    return PyEval_SaveThread() if _release_gil or cnt >= 16 else NULL
+
+cdef inline void _relock(PyThreadState* ts) noexcept:
+    if ts != NULL:
+        PyEval_RestoreThread(ts)
+
+cdef inline int _get_buffer(object obj, Py_buffer* view) except -1:
+    # PyObject_GetBuffer(obj, view, PyBUF_SIMPLE), minus the dispatch
+    # through the type for the common case of a bytes object.
+    if PyBytes_CheckExact(obj):
+        return PyBuffer_FillInfo(view, obj, PyBytes_AS_STRING(obj), PyBytes_GET_SIZE(obj), 1, PyBUF_SIMPLE)
+    return PyObject_GetBuffer(obj, view, PyBUF_SIMPLE)
+
+cdef extern from "Python.h":
+    bint PyUnicode_IS_COMPACT_ASCII(object o)
+
+cdef inline int _get_text(object obj, Py_buffer* view) except -1:
+    # _get_buffer for base58 text, which also takes a str (without an
+    # encode(): a compact ASCII str is read straight from its 1 byte data,
+    # any other str through its cached UTF-8).
+    cdef const char* p
+    cdef Py_ssize_t n
+    if PyBytes_CheckExact(obj):
+        PyBuffer_FillInfo(view, obj, PyBytes_AS_STRING(obj), PyBytes_GET_SIZE(obj), 1, PyBUF_SIMPLE)
+        return 0
+    if PyUnicode_Check(obj):
+        if PyUnicode_IS_COMPACT_ASCII(obj):
+            p = <const char*>PyUnicode_DATA(obj)
+            n = PyUnicode_GET_LENGTH(obj)
+        else:
+            p = PyUnicode_AsUTF8AndSize(obj, &n)
+        PyBuffer_FillInfo(view, obj, <void*>p, n, 1, PyBUF_SIMPLE)
+        return 0
+    PyObject_GetBuffer(obj, view, PyBUF_SIMPLE)
+    return 0
+
+cdef inline int _dec_ptr(const char* p, Py_ssize_t length, unsigned char* out, int n, unsigned long* err_off) noexcept nogil:
+    # Decodes the length characters at p to the n (32 or 64) bytes at out
+    # and returns FD_BASE58_SUCCESS or why they are invalid (see
+    # fd_base58_decode_{32,64}_ex).  The kernels read them in place.
+    if n == 32:
+        return fd58.fd_base58_decode_32_ex(p, <unsigned long>length, out, err_off)
+    return fd58.fd_base58_decode_64_ex(p, <unsigned long>length, out, err_off)
+
+cdef object _dec_error(int err, unsigned long err_off, Py_ssize_t idx=-1):
+    why = fd58.fd_base58_strerror(err).decode()
+    what = "Base58" if idx < 0 else f"Base58 item {idx}"
+    if err == fd58.FD_BASE58_ERR_CHAR or err == fd58.FD_BASE58_ERR_LEN:
+        return ValueError(f"Failed to decode {what}: {why} at offset {err_off}")
+    return ValueError(f"Failed to decode {what}: {why}")
+
+cdef inline int _dec(object encoded, unsigned char* out, int n) except -1:
+    # Decodes encoded (bytes, str or any buffer) to the n (32 or 64) bytes
+    # at out, raising a ValueError if it is invalid.
+    cdef Py_buffer view
+    cdef unsigned long err_off = 0
+    _get_text(encoded, &view)
+    cdef PyThreadState* ts = _unlock()
+    cdef int err = _dec_ptr(<const char*>view.buf, view.len, out, n, &err_off)
+    _relock(ts)
+    PyBuffer_Release(&view)
+    if err:
+        raise _dec_error(err, err_off)
+    return 0
+
+cdef inline int _get_data(object data, Py_buffer* view, Py_ssize_t n) except -1:
+    # _get_buffer for the n bytes to encode.
+    _get_buffer(data, view)
+    if view.len != n:
+        PyBuffer_Release(view)
+        raise ValueError(f"Data length must be {n} bytes")
+    return 0
+
+cdef inline object _enc_ptr(const unsigned char* p, int n, bint as_str):
+    # Encodes the n (32 or 64) bytes at p straight into a bytes, or an
+    # ASCII str if as_str, allocated at its final length.  Both have room
+    # for the nul the kernels write after the last character.
+    cdef object result
+    cdef char* out
+    cdef Py_ssize_t length = fd58.fd_base58_encoded_len_32(p) if n == 32 else fd58.fd_base58_encoded_len_64(p)
+    if as_str:
+        result = PyUnicode_New(length, 127)
+        out = <char*>PyUnicode_DATA(result)
+    else:
+        result = PyBytes_FromStringAndSize(NULL, length)
+        out = PyBytes_AS_STRING(result)
+    cdef PyThreadState* ts = _unlock()
+    if n == 32:
+        fd58.fd_base58_encode_32(p, NULL, out)
+    else:
+        fd58.fd_base58_encode_64(p, NULL, out)
+    _relock(ts)
+    return result
+
+cdef inline object _enc(object data, int n, bint as_str):
+    cdef Py_buffer view
+    if PyBytes_CheckExact(data):
+        if PyBytes_GET_SIZE(data) != n:
+            raise ValueError(f"Data length must be {n} bytes")
+        return _enc_ptr(<const unsigned char*>PyBytes_AS_STRING(data), n, as_str)
+    _get_data(data, &view, n)
+    try:
+        return _enc_ptr(<const unsigned char*>view.buf, n, as_str)
+    finally:
+        PyBuffer_Release(&view)
+
+def enc32(object data):
+    return _enc(data, 32, False)
+
+def enc64(object data):
+    return _enc(data, 64, False)
+
+def enc32_str(object data):
+    """Encode data like enc32, but return a str."""
+    return _enc(data, 32, True)
+
+def enc64_str(object data):
+    """Encode data like enc64, but return a str."""
+    return _enc(data, 64, True)
+
+def dec32(object encoded):
+    cdef unsigned char[32] out_buffer
+    _dec(encoded, out_buffer, 32)
+    return out_buffer[:32]
+
+def dec64(object encoded):
+    cdef unsigned char[64] out_buffer
+    _dec(encoded, out_buffer, 64)
+    return out_buffer[:64]
+
+def dec32_slice(object buf, Py_ssize_t offset, Py_ssize_t length):
+    """Decode the length bytes at offset in buf (a str or any object
+    supporting the buffer protocol) without copying them out first."""
+    cdef Py_buffer view
+    cdef unsigned char[32] out_buffer
+    _get_text(buf, &view)
+    if offset < 0 or length < 0 or offset > view.len - length:
+        PyBuffer_Release(&view)
+        raise ValueError("Slice out of range")
+    cdef unsigned long err_off = 0
+    cdef PyThreadState* ts = _unlock()
+    cdef int err = _dec_ptr(<const char*>view.buf + offset, length, out_buffer, 32, &err_off)
+    _relock(ts)
+    PyBuffer_Release(&view)
+    if err:
+        raise _dec_error(err, err_off)
+    return out_buffer[:32]
+
+def dec64_slice(object buf, Py_ssize_t offset, Py_ssize_t length):
+    """Decode the length bytes at offset in buf (a str or any object
+    supporting the buffer protocol) without copying them out first."""
+    cdef Py_buffer view
+    cdef unsigned char[64] out_buffer
+    _get_text(buf, &view)
+    if offset < 0 or length < 0 or offset > view.len - length:
+        PyBuffer_Release(&view)
+        raise ValueError("Slice out of range")
+    cdef unsigned long err_off = 0
+    cdef PyThreadState* ts = _unlock()
+    cdef int err = _dec_ptr(<const char*>view.buf + offset, length, out_buffer, 64, &err_off)
+    _relock(ts)
+    PyBuffer_Release(&view)
+    if err:
+        raise _dec_error(err, err_off)
+    return out_buffer[:64]
+
+cdef inline char* _get_out(object out, Py_buffer* view, Py_ssize_t offset, Py_ssize_t length) except NULL:
+    # Pins the writable buffer out and returns where the length bytes at
+    # offset in it start.  view is released on error.
+    PyObject_GetBuffer(out, view, PyBUF_WRITABLE)
+    if offset < 0:
+        PyBuffer_Release(view)
+        raise ValueError(f"Offset must not be negative, got {offset}")
+    if offset > view.len - length:
+        PyBuffer_Release(view)
+        raise ValueError("Output buffer too small")
+    return <char*>view.buf + offset
+
+def enc32_into(object data, object out, Py_ssize_t offset=0):
+    """Encode data like enc32, but write the characters (without a nul)
+    to the writable buffer out at offset.  Return how many were written."""
+    cdef Py_buffer view
+    cdef Py_buffer out_view
     cdef char[45] out_buffer
     cdef unsigned length = 0
-    if len(data) != 32:
-        raise ValueError("Data length must be 32 bytes")
-    cdef char* result = fd58.fd_base58_encode_32(<unsigned char*> data, &length, out_buffer)
-    if result == NULL:
-        raise MemoryError("Failed to encode Base58")
-    return out_buffer[:length]
-
-cpdef enc64(bytes data):
+    _get_data(data, &view, 32)
+    cdef PyThreadState* ts = _unlock()
+    fd58.fd_base58_encode_32(<const unsigned char*>view.buf, &length, out_buffer)
+    _relock(ts)
+    PyBuffer_Release(&view)
+    memcpy(_get_out(out, &out_view, offset, length), out_buffer, length)
+    PyBuffer_Release(&out_view)
+    return length
+
+def enc64_into(object data, object out, Py_ssize_t offset=0):
+    """Encode data like enc64, but write the characters (without a nul)
+    to the writable buffer out at offset.  Return how many were written."""
+    cdef Py_buffer view
+    cdef Py_buffer out_view
     cdef char[89] out_buffer
     cdef unsigned length = 0
-    if len(data) != 64:
-        raise ValueError("Data length must be 64 bytes")
-    cdef char* result = fd58.fd_base58_encode_64(<unsigned char*> data, &length, out_buffer)
-    if result == NULL:
-        raise MemoryError("Failed to encode Base58")
-    return out_buffer[:length]
-
-cpdef dec32(bytes encoded):
+    _get_data(data, &view, 64)
+    cdef PyThreadState* ts = _unlock()
+    fd58.fd_base58_encode_64(<const unsigned char*>view.buf, &length, out_buffer)
+    _relock(ts)
+    PyBuffer_Release(&view)
+    memcpy(_get_out(out, &out_view, offset, length), out_buffer, length)
+    PyBuffer_Release(&out_view)
+    return length
+
+def dec32_into(object encoded, object out, Py_ssize_t offset=0):
+    """Decode encoded like dec32, but write the 32 bytes to the writable
+    buffer out at offset.  Return 32.  out is left alone on failure."""
+    cdef Py_buffer out_view
     cdef unsigned char[32] out_buffer
-    cdef unsigned char* result = fd58.fd_base58_decode_32(<const char*>encoded, out_buffer)
-    if result == NULL:
-        raise ValueError("Failed to decode Base58")
-    return out_buffer[:32]
+    _dec(encoded, out_buffer, 32)
+    memcpy(_get_out(out, &out_view, offset, 32), out_buffer, 32)
+    PyBuffer_Release(&out_view)
+    return 32
 
-cpdef dec64(bytes encoded):
+def dec64_into(object encoded, object out, Py_ssize_t offset=0):
+    """Decode encoded like dec64, but write the 64 bytes to the writable
+    buffer out at offset.  Return 64.  out is left alone on failure."""
+    cdef Py_buffer out_view
     cdef unsigned char[64] out_buffer
-    cdef unsigned char* result = fd58.fd_base58_decode_64(<const char*>encoded, out_buffer)
-    if result == NULL:
-        raise ValueError("Failed to decode Base58")
-    return out_buffer[:64]
+    _dec(encoded, out_buffer, 64)
+    memcpy(_get_out(out, &out_view, offset, 64), out_buffer, 64)
+    PyBuffer_Release(&out_view)
+    return 64
+
+# Templates for array.clone, which makes the arrays the bulk APIs return.
+cdef array.array _status_template = array.array("b")
+cdef array.array _lens_template = array.array("B")
+
+def encoded_len32(object data):
+    """Return len(enc32(data)) without encoding."""
+    cdef Py_buffer view
+    _get_data(data, &view, 32)
+    cdef unsigned long length = fd58.fd_base58_encoded_len_32(<const unsigned char*>view.buf)
+    PyBuffer_Release(&view)
+    return length
+
+def encoded_len64(object data):
+    """Return len(enc64(data)) without encoding."""
+    cdef Py_buffer view
+    _get_data(data, &view, 64)
+    cdef unsigned long length = fd58.fd_base58_encoded_len_64(<const unsigned char*>view.buf)
+    PyBuffer_Release(&view)
+    return length
+
+cdef tuple _encoded_len_packed(object buf, int n):
+    cdef Py_buffer view
+    _get_buffer(buf, &view)
+    cdef Py_ssize_t cnt = view.len // n
+    cdef array.array lens
+    try:
+        if view.len % n:
+            raise ValueError(f"Data length must be a multiple of {n} bytes")
+        lens = array.clone(_lens_template, cnt, False)
+    except:
+        PyBuffer_Release(&view)
+        raise
+    cdef PyThreadState* ts = _unlock_bulk(cnt)
+    cdef unsigned long total
+    if n == 32:
+        total = fd58.fd_base58_encoded_len_32_batch(<const unsigned char*>view.buf, <unsigned long>cnt, lens.data.as_uchars)
+    else:
+        total = fd58.fd_base58_encoded_len_64_batch(<const unsigned char*>view.buf, <unsigned long>cnt, lens.data.as_uchars)
+    _relock(ts)
+    PyBuffer_Release(&view)
+    return total, lens
+
+def encoded_len32_packed(object buf):
+    """For buf holding 32 byte inputs back to back, return (total, lens):
+    the total length of their encodings and an array('B') with each one's
+    length, without encoding."""
+    return _encoded_len_packed(buf, 32)
+
+def encoded_len64_packed(object buf):
+    """Same as encoded_len32_packed, for 64 byte inputs."""
+    return _encoded_len_packed(buf, 64)
+
+# Per-item results of the _batch decoders (fd_base58.h's FD_BASE58_*).
+SUCCESS = fd58.FD_BASE58_SUCCESS
+ERR_LEN = fd58.FD_BASE58_ERR_LEN
+ERR_CHAR = fd58.FD_BASE58_ERR_CHAR
+ERR_OVERFLOW = fd58.FD_BASE58_ERR_OVERFLOW
+ERR_LEADING_ONES = fd58.FD_BASE58_ERR_LEADING_ONES
+
+
+# The list conversions work in two passes: one with the GIL, which finds
+# each item's data and allocates the results, and a loop over the kernels
+# without it.  They take a snapshot of the items in a list of their own,
+# even when given a list: another thread could change that one while the
+# GIL is released (or at any time, without a GIL), dropping the items the
+# kernels are reading.  The snapshot keeps them alive in between, and
+# bytes and str can't change.  Other buffers could, so the few bytes a
+# conversion reads are copied out of them into an arena.
+
+cdef struct _dec_item:
+    const char* p
+    Py_ssize_t length
+    unsigned char* out
+    unsigned long err_off
+    int err
+
+cdef int _dec_items(list seq, _dec_item* items, int n, char** arena) except -1:
+    # Decodes seq[i] to the n bytes at items[i].out (set by the caller)
+    # and stores the FD_BASE58_* result in items[i].err.  *arena is
+    # allocated on first use and freed by the caller.
+    cdef Py_ssize_t cnt = len(seq)
+    cdef Py_ssize_t max_len = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    cdef Py_buffer view
+    cdef char* slot
+    cdef object obj
+    cdef Py_ssize_t i
+    for i in range(cnt):
+        obj = seq[i]
+        if PyBytes_CheckExact(obj):
+            items[i].p = PyBytes_AS_STRING(obj)
+            items[i].length = PyBytes_GET_SIZE(obj)
+        elif PyUnicode_Check(obj):
+            if PyUnicode_IS_COMPACT_ASCII(obj):
+                items[i].p = <const char*>PyUnicode_DATA(obj)
+                items[i].length = PyUnicode_GET_LENGTH(obj)
+            else:
+                items[i].p = PyUnicode_AsUTF8AndSize(obj, &items[i].length)
+        else:
+            # Anything past max_len+1 characters fails the same way (too
+            # long, at offset max_len), so that is all that is copied.
+            PyObject_GetBuffer(obj, &view, PyBUF_SIMPLE)
+            if arena[0] == NULL:
+                arena[0] = <char*>PyMem_Malloc(cnt * (max_len + 1))
+                if arena[0] == NULL:
+                    PyBuffer_Release(&view)
+                    raise MemoryError()
+            slot = arena[0] + i * (max_len + 1)
+            items[i].length = min(view.len, max_len + 1)
+            memcpy(slot, view.buf, items[i].length)
+            PyBuffer_Release(&view)
+            items[i].p = slot
+    cdef PyThreadState* ts = _unlock_bulk(cnt)
+    for i in range(cnt):
+        items[i].err = _dec_ptr(items[i].p, items[i].length, items[i].out, n, &items[i].err_off)
+    _relock(ts)
+    return 0
+
+cdef list _dec_many(object items, int n):
+    cdef list seq = list(items)  # ours, see above
+    cdef Py_ssize_t cnt = len(seq)
+    cdef list out = [None] * cnt
+    cdef _dec_item* it = <_dec_item*>PyMem_Malloc(cnt * sizeof(_dec_item))
+    cdef char* arena = NULL
+    cdef bytes result
+    cdef Py_ssize_t i
+    if it == NULL:
+        raise MemoryError()
+    try:
+        for i in range(cnt):
+            result = PyBytes_FromStringAndSize(NULL, n)
+            out[i] = result
+            it[i].out = <unsigned char*>PyBytes_AS_STRING(result)
+        _dec_items(seq, it, n, &arena)
+        for i in range(cnt):
+            if it[i].err:
+                raise _dec_error(it[i].err, it[i].err_off, i)
+    finally:
+        PyMem_Free(arena)
+        PyMem_Free(it)
+    return out
+
+def dec32_many(items):
+    """Decode each of items (bytes, str or other buffers) like dec32 and
+    return a list of the results.  Raise a ValueError naming the first
+    invalid item, if any."""
+    return _dec_many(items, 32)
+
+def dec64_many(items):
+    """Same as dec32_many, for 64 byte results."""
+    return _dec_many(items, 64)
+
+cdef struct _enc_item:
+    const unsigned char* p
+    char* out
+
+cdef list _enc_many(object items, int n, bint as_str):
+    cdef list seq = list(items)  # ours, see above
+    cdef Py_ssize_t cnt = len(seq)
+    cdef list out = [None] * cnt
+    cdef _enc_item* it = <_enc_item*>PyMem_Malloc(cnt * sizeof(_enc_item))
+    cdef unsigned char* arena = NULL
+    cdef Py_buffer view
+    cdef object obj
+    cdef object result
+    cdef Py_ssize_t length
+    cdef Py_ssize_t i
+    cdef PyThreadState* ts
+    if it == NULL:
+        raise MemoryError()
+    try:
+        for i in range(cnt):
+            obj = seq[i]
+            if PyBytes_CheckExact(obj) and PyBytes_GET_SIZE(obj) == n:
+                it[i].p = <const unsigned char*>PyBytes_AS_STRING(obj)
+            else:
+                PyObject_GetBuffer(obj, &view, PyBUF_SIMPLE)
+                if view.len != n:
+                    PyBuffer_Release(&view)
+                    raise ValueError(f"Data length must be {n} bytes (item {i})")
+                if arena == NULL:
+                    arena = <unsigned char*>PyMem_Malloc(cnt * n)
+                    if arena == NULL:
+                        PyBuffer_Release(&view)
+                        raise MemoryError()
+                memcpy(arena + i * n, view.buf, n)
+                PyBuffer_Release(&view)
+                it[i].p = arena + i * n
+            length = fd58.fd_base58_encoded_len_32(it[i].p) if n == 32 else fd58.fd_base58_encoded_len_64(it[i].p)
+            if as_str:
+                result = PyUnicode_New(length, 127)
+                it[i].out = <char*>PyUnicode_DATA(result)
+            else:
+                result = PyBytes_FromStringAndSize(NULL, length)
+                it[i].out = PyBytes_AS_STRING(result)
+            out[i] = result
+        ts = _unlock_bulk(cnt)
+        if n == 32:
+            for i in range(cnt):
+                fd58.fd_base58_encode_32(it[i].p, NULL, it[i].out)
+        else:
+            for i in range(cnt):
+                fd58.fd_base58_encode_64(it[i].p, NULL, it[i].out)
+        _relock(ts)
+    finally:
+        PyMem_Free(arena)
+        PyMem_Free(it)
+    return out
+
+def enc32_many(items, bint as_str=False):
+    """Encode each of items (bytes or other buffers of 32 bytes) like
+    enc32, or like enc32_str if as_str, and return a list of the
+    results."""
+    return _enc_many(items, 32, as_str)
+
+def enc64_many(items, bint as_str=False):
+    """Same as enc32_many, for 64 byte inputs."""
+    return _enc_many(items, 64, as_str)
+
+cdef tuple _dec_batch(object items, int n):
+    # Decodes items[i] to bytes [n*i, n*(i+1)) of one bytes object and
+    # stores its FD_BASE58_* result in status[i], zeroing the row of an
+    # invalid item instead of raising.
+    cdef list seq = list(items)  # ours, see above
+    cdef Py_ssize_t cnt = len(seq)
+    cdef bytes out = PyBytes_FromStringAndSize(NULL, cnt * n)
+    cdef unsigned char* rows = <unsigned char*>PyBytes_AS_STRING(out)
+    cdef array.array status = array.clone(_status_template, cnt, False)
+    cdef _dec_item* it = <_dec_item*>PyMem_Malloc(cnt * sizeof(_dec_item))
+    cdef char* arena = NULL
+    cdef Py_ssize_t i
+    if it == NULL:
+        raise MemoryError()
+    try:
+        for i in range(cnt):
+            it[i].out = rows + i * n
+        _dec_items(seq, it, n, &arena)
+        for i in range(cnt):
+            if it[i].err:
+                memset(it[i].out, 0, n)
+            status.data.as_schars[i] = <signed char>it[i].err
+    finally:
+        PyMem_Free(arena)
+        PyMem_Free(it)
+    return out, status
+
+def dec32_batch(items):
+    """Decode each of items (bytes, str or other buffers) like dec32, but
+    without raising for invalid ones.  Return (data, status): data holds
+    the 32 byte results back to back, and status is an array('b') with
+    SUCCESS or the ERR_* saying why, per item.  Invalid items decode to
+    zeros."""
+    return _dec_batch(items, 32)
+
+def dec64_batch(items):
+    """Same as dec32_batch, for 64 byte results."""
+    return _dec_batch(items, 64)
+
+cdef Py_ssize_t _dec_offset_rows(const char* data, Py_ssize_t data_len, const void* offsets, bint large, Py_ssize_t cnt,
+                                 unsigned char* out, int n, signed char* status) noexcept nogil:
+    # Decodes row i, data[offsets[i]:offsets[i+1]], in place to the n
+    # bytes at out+i*n and stores its FD_BASE58_* result in status[i],
+    # zeroing the row if it is invalid.  Returns the index of the first
+    # row whose offsets are out of range (stopping there), or -1.
+    cdef int64_t start
+    cdef int64_t end
+    cdef Py_ssize_t i
+    for i in range(cnt):
+        if large:
+            start = (<const int64_t*>offsets)[i]
+            end = (<const int64_t*>offsets)[i + 1]
+        else:
+            start = (<const int32_t*>offsets)[i]
+            end = (<const int32_t*>offsets)[i + 1]
+        if start < 0 or start > end or end > data_len:
+            return i
+        status[i] = <signed char>_dec_ptr(data + start, end - start, out + i * n, n, NULL)
+        if status[i]:
+            memset(out + i * n, 0, n)
+    return -1
+
+cdef int _offsets_large(const Py_buffer* view) except -1:
+    # Whether the offsets in view are int64 (1) or int32 (0).
+    fmt = (<bytes>view.format if view.format != NULL else b"B").lstrip(b"@=<")
+    if fmt not in (b"i", b"l", b"q") or view.itemsize not in (4, 8):
+        raise ValueError(f"Offsets must be int32 or int64, not {fmt.decode()!r}")
+    return view.itemsize == 8
+
+cdef tuple _dec_offsets(object data, object offsets, object out, int n):
+    cdef Py_buffer view
+    cdef Py_buffer off_view
+    cdef Py_buffer out_view
+    cdef unsigned char* rows
+    cdef array.array status
+    cdef bint large
+    cdef Py_ssize_t cnt
+    cdef Py_ssize_t bad
+    cdef PyThreadState* ts
+    cdef bint have_out = False
+    _get_text(data, &view)
+    try:
+        PyObject_GetBuffer(offsets, &off_view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS)
+    except:
+        PyBuffer_Release(&view)
+        raise
+    try:
+        large = _offsets_large(&off_view)
+        if off_view.len < off_view.itemsize:
+            raise ValueError("Offsets must have at least one element")
+        cnt = off_view.len // off_view.itemsize - 1
+        status = array.clone(_status_template, cnt, False)
+        if out is None:
+            out = PyBytes_FromStringAndSize(NULL, cnt * n)
+            rows = <unsigned char*>PyBytes_AS_STRING(out)
+        else:
+            rows = <unsigned char*>_get_out(out, &out_view, 0, cnt * n)
+            have_out = True
+        ts = _unlock_bulk(cnt)
+        bad = _dec_offset_rows(<const char*>view.buf, view.len, off_view.buf, large, cnt, rows, n, status.data.as_schars)
+        _relock(ts)
+        if bad >= 0:
+            raise ValueError(f"Offsets of row {bad} are out of range")
+    finally:
+        if have_out:
+            PyBuffer_Release(&out_view)
+        PyBuffer_Release(&off_view)
+        PyBuffer_Release(&view)
+    return out, status
+
+def dec32_offsets(object data, object offsets, object out=None):
+    """Decode the rows of a string column stored as one blob, data (bytes,
+    str or any buffer), and an int32 or int64 array of n+1 offsets into it:
+    row i is data[offsets[i]:offsets[i+1]], and is decoded in place.
+    Write the 32 byte results back to back to out (a writable buffer of at
+    least 32*n bytes), or a new bytes if out is None, and return (out,
+    status) like dec32_batch: invalid rows are zeroed and have their
+    ERR_* in status.  Offsets out of range raise a ValueError."""
+    return _dec_offsets(data, offsets, out, 32)
+
+def dec64_offsets(object data, object offsets, object out=None):
+    """Same as dec32_offsets, for 64 byte results."""
+    return _dec_offsets(data, offsets, out, 64)
+
+cdef tuple _enc_packed(object buf, int n):
+    cdef Py_ssize_t width = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    cdef Py_buffer view
+    _get_buffer(buf, &view)
+    cdef Py_ssize_t cnt = view.len // n
+    cdef bytes slots
+    cdef array.array lens
+    try:
+        if view.len % n:
+            raise ValueError(f"Data length must be a multiple of {n} bytes")
+        slots = PyBytes_FromStringAndSize(NULL, cnt * width)
+        lens = array.clone(_lens_template, cnt, False)
+    except:
+        PyBuffer_Release(&view)
+        raise
+    cdef PyThreadState* ts = _unlock_bulk(cnt)
+    if n == 32:
+        fd58.fd_base58_encode_32_packed(<const unsigned char*>view.buf, <unsigned long>cnt, lens.data.as_uchars, PyBytes_AS_STRING(slots))
+    else:
+        fd58.fd_base58_encode_64_packed(<const unsigned char*>view.buf, <unsigned long>cnt, lens.data.as_uchars, PyBytes_AS_STRING(slots))
+    _relock(ts)
+    PyBuffer_Release(&view)
+    return slots, lens
+
+def enc32_packed(object buf):
+    """For buf holding 32 byte inputs back to back, return (slots, lens):
+    a bytes with each one's encoding in a 44 character slot, padded with
+    nuls, and an array('B') with each one's length."""
+    return _enc_packed(buf, 32)
+
+def enc64_packed(object buf):
+    """Same as enc32_packed, for 64 byte inputs and 88 character slots."""
+    return _enc_packed(buf, 64)
+
+cdef Py_ssize_t _dec_slots(const char* slots, Py_ssize_t width, const unsigned char* lens, Py_ssize_t cnt,
+                           unsigned char* out, int n, signed char* status, unsigned long* err_off) noexcept nogil:
+    # Decodes the cnt slots of width characters at slots to the n (32 or
+    # 64) bytes each at out, as fd_base58_decode_{32,64}_packed does (which
+    # it uses when width is the maximum length, and other widths slot by
+    # slot).  Returns the index of the first invalid slot, with the offset
+    # of its error in *err_off, or -1 if all are valid.
+    cdef Py_ssize_t max_len = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    cdef unsigned char[64] scratch
+    cdef unsigned long valid_cnt
+    cdef unsigned long off = 0
+    cdef Py_ssize_t first = -1
+    cdef Py_ssize_t length
+    cdef Py_ssize_t i
+    if width == max_len:
+        if n == 32:
+            valid_cnt = fd58.fd_base58_decode_32_packed(slots, lens, <unsigned long>cnt, out, status)
+        else:
+            valid_cnt = fd58.fd_base58_decode_64_packed(slots, lens, <unsigned long>cnt, out, status)
+        if valid_cnt == <unsigned long>cnt:
+            return -1
+        first = 0
+        while status[first] == fd58.FD_BASE58_SUCCESS:
+            first += 1
+        # Rerun the first invalid slot for the offset of the error.
+        length = lens[first] if lens != NULL else <Py_ssize_t>strnlen(slots + first * width, width)
+        _dec_ptr(slots + first * width, length, scratch, n, err_off)
+        return first
+    for i in range(cnt):
+        length = lens[i] if lens != NULL else <Py_ssize_t>strnlen(slots + i * width, width)
+        status[i] = <signed char>_dec_ptr(slots + i * width, length, out + i * n, n, &off)
+        if status[i]:
+            memset(out + i * n, 0, n)
+            if first < 0:
+                first = i
+                err_off[0] = off
+    return first
+
+cdef bytes _dec_packed(object slots, object lens, int n):
+    cdef Py_ssize_t width = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    cdef Py_buffer view
+    cdef Py_buffer lens_view
+    lens_view.buf = NULL
+    _get_buffer(slots, &view)
+    cdef Py_ssize_t cnt = view.len // width
+    cdef bytes out
+    cdef array.array status
+    try:
+        if view.len % width:
+            raise ValueError(f"Slots length must be a multiple of {width} bytes")
+        if lens is not None:
+            _get_buffer(lens, &lens_view)
+            if lens_view.len != cnt:
+                raise ValueError(f"Expected {cnt} lengths, got {lens_view.len}")
+        out = PyBytes_FromStringAndSize(NULL, cnt * n)
+        status = array.clone(_status_template, cnt, False)
+    except:
+        if lens_view.buf != NULL:
+            PyBuffer_Release(&lens_view)
+        PyBuffer_Release(&view)
+        raise
+    cdef unsigned long err_off = 0
+    cdef PyThreadState* ts = _unlock_bulk(cnt)
+    cdef Py_ssize_t bad = _dec_slots(<const char*>view.buf, width, <const unsigned char*>lens_view.buf, cnt,
+                                     <unsigned char*>PyBytes_AS_STRING(out), n, status.data.as_schars, &err_off)
+    _relock(ts)
+    if lens_view.buf != NULL:
+        PyBuffer_Release(&lens_view)
+    PyBuffer_Release(&view)
+    if bad >= 0:
+        raise _dec_error(status.data.as_schars[bad], err_off, bad)
+    return out
+
+def dec32_packed(object slots, object lens=None):
+    """Decode the 44 character slots back to back in slots (as made by
+    enc32_packed) and return the 32 byte results back to back in one bytes.
+    lens (a buffer of one byte per slot, e.g. an array('B')) gives each
+    slot's length; without it, a slot ends at its first nul.  Raise a
+    ValueError naming the first invalid slot, if any."""
+    return _dec_packed(slots, lens, 32)
+
+def dec64_packed(object slots, object lens=None):
+    """Same as dec32_packed, for 88 character slots and 64 byte results."""
+    return _dec_packed(slots, lens, 64)
+
+# NumPy support.  numpy is imported on first use, so it isn't needed to
+# build or import fd58: the arrays are read and written through the
+# buffer protocol, and their memory is exactly the packed layout above.
+
+cdef object _enc_array(object arr, int n):
+    import numpy as np
+    cdef Py_ssize_t width = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    a = np.ascontiguousarray(arr)
+    if a.dtype.kind == "V" and a.dtype.itemsize == n:
+        shape = a.shape
+    elif a.dtype == np.uint8 and a.ndim >= 1 and a.shape[-1] == n:
+        shape = a.shape[:-1]
+    else:
+        raise ValueError(f"Expected a uint8 array of shape (..., {n}) or an array of dtype 'V{n}'")
+    out = np.empty(shape, f"S{width}")
+    cdef Py_buffer view
+    cdef Py_buffer out_view
+    _get_buffer(a, &view)
+    PyObject_GetBuffer(out, &out_view, PyBUF_WRITABLE)
+    cdef Py_ssize_t cnt = view.len // n
+    cdef PyThreadState* ts = _unlock_bulk(cnt)
+    if n == 32:
+        fd58.fd_base58_encode_32_packed(<const unsigned char*>view.buf, <unsigned long>cnt, NULL, <char*>out_view.buf)
+    else:
+        fd58.fd_base58_encode_64_packed(<const unsigned char*>view.buf, <unsigned long>cnt, NULL, <char*>out_view.buf)
+    _relock(ts)
+    PyBuffer_Release(&out_view)
+    PyBuffer_Release(&view)
+    return out
+
+def enc32_array(arr):
+    """Encode a NumPy array of 32 byte keys (uint8 of shape (..., 32), or
+    dtype 'V32') like enc32, and return an array of dtype 'S44' (of shape
+    (...))."""
+    return _enc_array(arr, 32)
+
+def enc64_array(arr):
+    """Same as enc32_array, for 64 byte keys and dtype 'S88'."""
+    return _enc_array(arr, 64)
+
+cdef object _dec_array(object arr, int n):
+    import numpy as np
+    a = np.ascontiguousarray(arr)
+    if a.dtype.kind == "U":
+        a = a.astype(f"S{a.dtype.itemsize // 4}")
+    if a.dtype.kind != "S":
+        raise ValueError(f"Expected an array of dtype 'S' or 'U', not {a.dtype}")
+    out = np.empty(a.shape + (n,), np.uint8)
+    cdef Py_ssize_t cnt = a.size
+    cdef Py_ssize_t width = a.dtype.itemsize
+    cdef array.array status = array.clone(_status_template, cnt, False)
+    cdef unsigned long err_off = 0
+    cdef Py_buffer view
+    cdef Py_buffer out_view
+    _get_buffer(a, &view)
+    PyObject_GetBuffer(out, &out_view, PyBUF_WRITABLE)
+    cdef PyThreadState* ts = _unlock_bulk(cnt)
+    cdef Py_ssize_t bad = _dec_slots(<const char*>view.buf, width, NULL, cnt,
+                                     <unsigned char*>out_view.buf, n, status.data.as_schars, &err_off)
+    _relock(ts)
+    PyBuffer_Release(&out_view)
+    PyBuffer_Release(&view)
+    if bad >= 0:
+        raise _dec_error(status.data.as_schars[bad], err_off, bad)
+    return out
+
+def dec32_array(arr):
+    """Decode a NumPy array of base58 strings (dtype 'S' or 'U', such as
+    the 'S44' arrays enc32_array makes) like dec32, and return a uint8
+    array of shape arr.shape + (32,) (use .view('V32') for one key per
+    element).  Raise a ValueError naming the first invalid element (by
+    its flat index), if any."""
+    return _dec_array(arr, 32)
+
+def dec64_array(arr):
+    """Same as dec32_array, for 64 byte results."""
+    return _dec_array(arr, 64)
+
+# Arrow support, through the C Data Interface (fd_arrow.h) and the
+# PyCapsule interface on top of it (__arrow_c_array__), so pyarrow,
+# Polars, DuckDB and others can hand columns over without fd58 depending
+# on any of them.  Columns are converted straight between the Arrow
+# buffers, without an object per row.
+
+cdef extern from "fd_arrow.h":
+    struct ArrowSchema:
+        const char* format
+        const char* name
+        const char* metadata
+        int64_t flags
+        int64_t n_children
+        ArrowSchema** children
+        ArrowSchema* dictionary
+        void (*release)(ArrowSchema*) noexcept nogil
+        void* private_data
+    struct ArrowArray:
+        int64_t length
+        int64_t null_count
+        int64_t offset
+        int64_t n_buffers
+        int64_t n_children
+        const void** buffers
+        ArrowArray** children
+        ArrowArray* dictionary
+        void (*release)(ArrowArray*) noexcept nogil
+        void* private_data
+    enum:
+        ARROW_FLAG_NULLABLE
+
+cdef void _release_schema(ArrowSchema* schema) noexcept nogil:
+    # The strings are static, there is nothing to free.
+    schema.release = NULL
+
+cdef void _release_array(ArrowArray* arr) noexcept nogil:
+    # The buffers belong to the ArrowColumn in private_data.
+    with gil:
+        Py_DECREF(<object>arr.private_data)
+    arr.release = NULL
+
+cdef void _free_schema_capsule(object capsule) noexcept:
+    cdef ArrowSchema* schema = <ArrowSchema*>PyCapsule_GetPointer(capsule, "arrow_schema")
+    if schema.release != NULL:
+        schema.release(schema)
+    free(schema)
+
+cdef void _free_array_capsule(object capsule) noexcept:
+    cdef ArrowArray* arr = <ArrowArray*>PyCapsule_GetPointer(capsule, "arrow_array")
+    if arr.release != NULL:
+        arr.release(arr)
+    free(arr)
+
+cdef class ArrowColumn:
+    """A column made by the *_arrow conversions.  It is exported through
+    the Arrow PyCapsule interface, e.g. pyarrow.array(col), and can be
+    exported any number of times: the exports share its buffers."""
+    cdef const char* format
+    cdef int64_t length
+    cdef int64_t null_count
+    cdef int64_t n_buffers
+    cdef const void* buffers[3]
+
+    def __dealloc__(self):
+        cdef int i
+        for i in range(3):
+            free(<void*>self.buffers[i])
+
+    def __len__(self):
+        return self.length
+
+    def __arrow_c_schema__(self):
+        cdef ArrowSchema* schema = <ArrowSchema*>malloc(sizeof(ArrowSchema))
+        if schema == NULL:
+            raise MemoryError()
+        schema.format = self.format
+        schema.name = ""
+        schema.metadata = NULL
+        schema.flags = ARROW_FLAG_NULLABLE
+        schema.n_children = 0
+        schema.children = NULL
+        schema.dictionary = NULL
+        schema.release = _release_schema
+        schema.private_data = NULL
+        return PyCapsule_New(schema, "arrow_schema", <PyCapsule_Destructor>_free_schema_capsule)
+
+    def __arrow_c_array__(self, requested_schema=None):
+        # requested_schema is only a hint, and there is just one way to
+        # export the column.
+        schema_capsule = self.__arrow_c_schema__()
+        cdef ArrowArray* arr = <ArrowArray*>malloc(sizeof(ArrowArray))
+        if arr == NULL:
+            raise MemoryError()
+        arr.length = self.length
+        arr.null_count = self.null_count
+        arr.offset = 0
+        arr.n_buffers = self.n_buffers
+        arr.n_children = 0
+        arr.buffers = self.buffers
+        arr.children = NULL
+        arr.dictionary = NULL
+        arr.release = _release_array
+        arr.private_data = <void*>self
+        Py_INCREF(self)
+        return schema_capsule, PyCapsule_New(arr, "arrow_array", <PyCapsule_Destructor>_free_array_capsule)
+
+cdef tuple _arrow_import(object obj):
+    # Returns the (schema, array) capsules of obj, an object with
+    # __arrow_c_array__ (a pyarrow.Array, ...) or such a pair itself.
+    # The producer frees the array when the capsules go away.
+    capsules = obj.__arrow_c_array__() if hasattr(obj, "__arrow_c_array__") else obj
+    if type(capsules) is not tuple or len(capsules) != 2:
+        raise TypeError("Expected an Arrow array (with __arrow_c_array__) or a (schema, array) pair of capsules")
+    return capsules
+
+cdef inline bint _arrow_valid(const uint8_t* validity, int64_t i) noexcept nogil:
+    return validity == NULL or (validity[i >> 3] >> (i & 7)) & 1
+
+cdef int _arrow_validity(ArrowColumn col, const ArrowArray* arr) except -1:
+    # Copies the validity bitmap of arr (if it has nulls) to col, shifted
+    # to offset 0.
+    cdef const uint8_t* validity = <const uint8_t*>arr.buffers[0] if arr.null_count != 0 else NULL
+    cdef int64_t i
+    cdef uint8_t* bits
+    col.null_count = arr.null_count if validity != NULL else 0
+    if validity == NULL:
+        return 0
+    bits = <uint8_t*>malloc((arr.length + 7) // 8 + 1)
+    if bits == NULL:
+        raise MemoryError()
+    col.buffers[0] = bits
+    if arr.offset % 8 == 0:
+        memcpy(bits, validity + arr.offset // 8, (arr.length + 7) // 8)
+        return 0
+    memset(bits, 0, (arr.length + 7) // 8)
+    for i in range(arr.length):
+        if _arrow_valid(validity, arr.offset + i):
+            bits[i >> 3] |= <uint8_t>(1 << (i & 7))
+    return 0
+
+cdef void _enc_arrow_rows(const unsigned char* src, const uint8_t* validity, int64_t validity_off, int64_t cnt, int n,
+                          bint large, void* offsets, char* data) noexcept nogil:
+    # Encodes the cnt rows of n bytes at src a chunk at a time into fixed
+    # width slots (with the batch kernels), and packs the valid ones back
+    # to back at data, filling in their offsets.  Null rows are encoded
+    # too, but left empty.
+    cdef char[128 * 88] slots
+    cdef unsigned char[128] lens
+    cdef int64_t width = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    cdef int64_t pos = 0
+    cdef int64_t i
+    cdef int64_t j
+    cdef int64_t chunk_cnt
+    if large:
+        (<int64_t*>offsets)[0] = 0
+    else:
+        (<int32_t*>offsets)[0] = 0
+    for i in range(0, cnt, 128):
+        chunk_cnt = min(cnt - i, 128)
+        if n == 32:
+            fd58.fd_base58_encode_32_packed(src + i * n, <unsigned long>chunk_cnt, lens, slots)
+        else:
+            fd58.fd_base58_encode_64_packed(src + i * n, <unsigned long>chunk_cnt, lens, slots)
+        for j in range(chunk_cnt):
+            if _arrow_valid(validity, validity_off + i + j):
+                memcpy(data + pos, slots + j * width, lens[j])
+                pos += lens[j]
+            if large:
+                (<int64_t*>offsets)[i + j + 1] = pos
+            else:
+                (<int32_t*>offsets)[i + j + 1] = <int32_t>pos
+
+cdef ArrowColumn _enc_arrow(object obj, int n):
+    schema_capsule, array_capsule = _arrow_import(obj)
+    cdef const ArrowSchema* schema = <const ArrowSchema*>PyCapsule_GetPointer(schema_capsule, "arrow_schema")
+    cdef const ArrowArray* arr = <const ArrowArray*>PyCapsule_GetPointer(array_capsule, "arrow_array")
+    fmt = f"w:{n}".encode()
+    if schema.format == NULL or <bytes>schema.format != fmt or arr.n_buffers != 2:
+        raise ValueError(f"Expected a FixedSizeBinary({n}) Arrow array")
+    cdef int64_t width = fd58.FD_BASE58_ENCODED_32_LEN if n == 32 else fd58.FD_BASE58_ENCODED_64_LEN
+    # Utf8 has 32 bit offsets, columns with more characters than that
+    # become LargeUtf8.
+    cdef bint large = arr.length * width > 0x7fffffff
+    cdef ArrowColumn col = ArrowColumn.__new__(ArrowColumn)
+    col.format = "U" if large else "u"
+    col.length = arr.length
+    col.n_buffers = 3
+    _arrow_validity(col, arr)
+    col.buffers[1] = malloc((arr.length + 1) * (8 if large else 4))
+    col.buffers[2] = malloc(arr.length * width + 1)
+    if col.buffers[1] == NULL or col.buffers[2] == NULL:
+        raise MemoryError()
+    cdef PyThreadState* ts = _unlock_bulk(arr.length)
+    _enc_arrow_rows(<const unsigned char*>arr.buffers[1] + arr.offset * n, <const uint8_t*>col.buffers[0], 0,
+                    arr.length, n, large, <void*>col.buffers[1], <char*>col.buffers[2])
+    _relock(ts)
+    return col
+
+def enc32_arrow(arr):
+    """Encode a FixedSizeBinary(32) Arrow array (e.g. a pyarrow.Array, or
+    anything with __arrow_c_array__) like enc32, and return the Utf8
+    column as an ArrowColumn (pyarrow.array(col) imports it).  Nulls stay
+    null."""
+    return _enc_arrow(arr, 32)
+
+def enc64_arrow(arr):
+    """Same as enc32_arrow, for FixedSizeBinary(64)."""
+    return _enc_arrow(arr, 64)
+
+cdef Py_ssize_t _dec_arrow_rows(const char* data, const void* offsets, bint large, int64_t off, const uint8_t* validity,
+                                int64_t cnt, unsigned char* out, int n, int* err, unsigned long* err_off) noexcept nogil:
+    # Decodes the valid ones of the cnt strings given by offsets[off:] in
+    # data in place, zeroing the rows of nulls.  Returns the index of the
+    # first invalid one (with why in *err and *err_off, or *err 0 if its
+    # offsets are out of order) or -1.  The end of data isn't known here,
+    # so offsets past it can't be caught.
+    cdef int64_t start
+    cdef int64_t end
+    cdef int64_t i
+    for i in range(cnt):
+        if not _arrow_valid(validity, i):
+            memset(out + i * n, 0, n)
+            continue
+        if large:
+            start = (<const int64_t*>offsets)[off + i]
+            end = (<const int64_t*>offsets)[off + i + 1]
+        else:
+            start = (<const int32_t*>offsets)[off + i]
+            end = (<const int32_t*>offsets)[off + i + 1]
+        if start < 0 or start > end:
+            err[0] = 0
+            return i
+        err[0] = _dec_ptr(data + start, end - start, out + i * n, n, err_off)
+        if err[0]:
+            return i
+    return -1
+
+cdef ArrowColumn _dec_arrow(object obj, int n):
+    schema_capsule, array_capsule = _arrow_import(obj)
+    cdef const ArrowSchema* schema = <const ArrowSchema*>PyCapsule_GetPointer(schema_capsule, "arrow_schema")
+    cdef const ArrowArray* arr = <const ArrowArray*>PyCapsule_GetPointer(array_capsule, "arrow_array")
+    fmt = <bytes>schema.format if schema.format != NULL else b""
+    if fmt not in (b"u", b"U", b"z", b"Z") or arr.n_buffers != 3:
+        raise ValueError("Expected a Utf8, LargeUtf8, Binary or LargeBinary Arrow array")
+    cdef bint large = fmt in (b"U", b"Z")
+    cdef ArrowColumn col = ArrowColumn.__new__(ArrowColumn)
+    col.format = "w:32" if n == 32 else "w:64"
+    col.length = arr.length
+    col.n_buffers = 2
+    _arrow_validity(col, arr)
+    col.buffers[1] = malloc(arr.length * n + 1)
+    if col.buffers[1] == NULL:
+        raise MemoryError()
+    cdef int err = 0
+    cdef unsigned long err_off = 0
+    cdef PyThreadState* ts = _unlock_bulk(arr.length)
+    cdef Py_ssize_t bad = _dec_arrow_rows(<const char*>arr.buffers[2], arr.buffers[1], large, arr.offset,
+                                          <const uint8_t*>col.buffers[0], arr.length,
+                                          <unsigned char*>col.buffers[1], n, &err, &err_off)
+    _relock(ts)
+    if bad >= 0 and err == 0:
+        raise ValueError(f"Offsets of row {bad} are out of range")
+    if bad >= 0:
+        raise _dec_error(err, err_off, bad)
+    return col
+
+def dec32_arrow(arr):
+    """Decode a Utf8 (or LargeUtf8, Binary, LargeBinary) Arrow array like
+    dec32, and return the FixedSizeBinary(32) column as an ArrowColumn.
+    Nulls stay null.  Raise a ValueError naming the first invalid row, if
+    any."""
+    return _dec_arrow(arr, 32)
+
+def dec64_arrow(arr):
+    """Same as dec32_arrow, for FixedSizeBinary(64)."""
+    return _dec_arrow(arr, 64)
+
+_OPS = {"enc32": 0, "enc64": 1, "dec32": 2, "dec64": 3}
+
+cdef int _op(op) except -2:
+    if op is None:
+        return -1
+    try:
+        return _OPS[op]
+    except KeyError:
+        raise ValueError(f"Unknown op {op!r}, expected one of {', '.join(_OPS)}") from None
+
+def backends():
+    """Return the names of the backends this CPU supports, most preferred first."""
+    cdef list names = []
+    cdef unsigned long i = 0
+    cdef const char* name = fd58.fd_base58_backend_name(i)
+    while name != NULL:
+        names.append(name.decode())
+        i += 1
+        name = fd58.fd_base58_backend_name(i)
+    return names
+
+def backend(op=None):
+    """Return the name of the backend used for op ("enc32", "enc64", "dec32"
+    or "dec64"), or for all of them if op is None ("mixed" if they differ)."""
+    return fd58.fd_base58_backend(_op(op)).decode()
+
+def set_backend(name, op=None):
+    """Use the backend called name (one of backends(), or "auto" for the
+    default) for op, or for all ops if op is None."""
+    cdef int c_op = _op(op)
+    if fd58.fd_base58_set_backend(name.encode(), c_op) != 0:
+        raise ValueError(f"Unknown or unsupported backend {name!r}, expected one of {', '.join(backends())} or 'auto'")
+
+def set_release_gil(bint enabled):
+    """Release the GIL around each conversion if enabled, and return the
+    previous setting.  Off by default: releasing and reacquiring the GIL
+    costs about as much as a 32 byte conversion, so it only pays when
+    other threads have Python code to run meanwhile.  Free-threaded builds
+    of CPython have no GIL to release and run conversions in parallel
+    either way.
+
+    This only governs the conversions of one item.  Those of 16 items or
+    more at once (the _many, _batch, _packed, _offsets, _array and _arrow
+    functions, and encoded_len32_packed and encoded_len64_packed) always
+    release the GIL, which costs them next to nothing per item."""
+    global _release_gil
+    cdef bint prev = _release_gil
+    _release_gil = enabled
+    return prev
+
+
+# Autotuning.  Which backend is fastest depends on the microarchitecture
+# more than on what cpuid reports (e.g. 512-bit code can run at a lower
+# clock), so on first import each backend is timed for each op and the
+# winners are saved per CPU model.  Later imports just reuse them.
+#
+#   FD58_RETUNE=1     retune even if there are saved results
+#   FD58_AUTOTUNE=0   don't tune at all, use the cpuid based defaults
+#   FD58_CACHE_DIR    where to save the results (default ~/.cache/fd58)
+
+_TUNE_VERSION = 2  # Bump when kernels change enough to invalidate results
+
+cdef double _time_op(int op, unsigned long iters, bint batch=False):
+    # Returns the seconds per conversion of op on its bound backend, one
+    # at a time or, if batch, 8 at a time through the batch conversion.
+    cdef unsigned char[8][64] raw
+    cdef char[8][89] txt
+    cdef const char* ptrs[8]
+    cdef unsigned char[8 * 64] out_raw
+    cdef char[8 * 89] out_txt
+    cdef unsigned long i
+    cdef unsigned k
+    for i in range(8):
+        for k in range(64):
+            raw[i][k] = <unsigned char>((i * 64 + k) * 167 + 13)
+        if op == 2:
+            fd58.fd_base58_encode_32(raw[i], NULL, txt[i])
+        else:
+            fd58.fd_base58_encode_64(raw[i], NULL, txt[i])
+        ptrs[i] = txt[i]
+    t0 = time.perf_counter()
+    if batch:
+        # The encodes take the first 8*32 or 8*64 bytes of raw as 8
+        # inputs, the decodes the 8 cstrs in txt.
+        for i in range(0, iters, 8):
+            if op == 0:
+                fd58.fd_base58_encode_32_batch(&raw[0][0], 8, NULL, out_txt)
+            elif op == 1:
+                fd58.fd_base58_encode_64_batch(&raw[0][0], 8, NULL, out_txt)
+            elif op == 2:
+                fd58.fd_base58_decode_32_batch(ptrs, 8, out_raw, NULL)
+            else:
+                fd58.fd_base58_decode_64_batch(ptrs, 8, out_raw, NULL)
+    elif op == 0:
+        for i in range(iters):
+            fd58.fd_base58_encode_32(raw[i & 7], NULL, out_txt)
+    elif op == 1:
+        for i in range(iters):
+            fd58.fd_base58_encode_64(raw[i & 7], NULL, out_txt)
+    elif op == 2:
+        for i in range(iters):
+            fd58.fd_base58_decode_32(txt[i & 7], out_raw)
+    else:
+        for i in range(iters):
+            fd58.fd_base58_decode_64(txt[i & 7], out_raw)
+    return (time.perf_counter() - t0) / iters
+
+def _kernel_time(op, unsigned long iters=2048):
+    """Return the seconds per conversion of op on its bound backend, timed
+    in a C loop (see bench/bench_calls.py)."""
+    if op is None:
+        raise ValueError("op is required")
+    return _time_op(_op(op), iters)
+
+def _cpu_model():
+    fields = []
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if not line.strip():
+                    break
+                if line.split(":")[0].strip() in ("vendor_id", "cpu family", "model", "model name", "stepping"):
+                    fields.append(line.split(":", 1)[1].strip())
+    except OSError:
+        pass
+    if not fields:
+        import platform
+        fields = [platform.machine(), platform.processor()]
+    return " / ".join(fields)
+
+def _cache_path():
+    d = os.environ.get("FD58_CACHE_DIR")
+    if not d:
+        d = os.path.join(os.environ.get("XDG_CACHE_HOME") or os.path.join(os.path.expanduser("~"), ".cache"), "fd58")
+    return os.path.join(d, "autotune.json")
+
+def _load_cache(path):
+    try:
+        with open(path) as f:
+            cache = json.load(f)
+        return cache if isinstance(cache, dict) else {}
+    except (OSError, ValueError):
+        return {}
+
+def _save_cache(path, cache):
+    try:
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        tmp = f"{path}.{os.getpid()}.{threading.get_ident()}"
+        with open(tmp, "w") as f:
+            json.dump(cache, f, indent=1, sort_keys=True)
+        os.replace(tmp, path)
+    except OSError:
+        pass
+
+def autotune(force=False):
+    """Bind each op to the backend that is fastest on this CPU and return
+    the choice as a dict of op -> backend name.  Reuses the result saved for
+    this CPU model unless force is true (or FD58_RETUNE=1 is set)."""
+    names = backends()
+    key = f"{_cpu_model()} | {','.join(names)} | v{_TUNE_VERSION}"
+    path = _cache_path()
+    cache = _load_cache(path)
+    force = force or os.environ.get("FD58_RETUNE", "0") not in ("", "0")
+
+    choice = cache.get(key)
+    if not force and isinstance(choice, dict) and set(choice) == set(_OPS) and set(choice.values()) <= set(names):
+        for op, name in choice.items():
+            set_backend(name, op)
+        return dict(choice)
+
+    # Warm up first (the vector units and clock can take a while to get
+    # going), then interleave the backends over a few rounds and keep the
+    # best time of each, so that a burst of noise doesn't decide the winner.
+    for op, c_op in _OPS.items():
+        for name in names:
+            set_backend(name, op)
+            _time_op(c_op, 512)
+            _time_op(c_op, 512, True)
+
+    choice = {}
+    for op, c_op in _OPS.items():
+        best = {}
+        for _ in range(5):
+            for name in names:
+                set_backend(name, op)
+                _time_op(c_op, 64)  # warm up
+                # The batch conversions follow the binding too, so they
+                # count as much as the single ones.
+                t = _time_op(c_op, 2048) + _time_op(c_op, 2048, True)
+                best[name] = min(t, best.get(name, t))
+        choice[op] = min(names, key=best.__getitem__)
+        set_backend(choice[op], op)
+
+    cache[key] = choice
+    _save_cache(path, cache)
+    return dict(choice)
+
+if os.environ.get("FD58_AUTOTUNE", "1") != "0":
+    # Cache I/O errors are handled in autotune, so anything else is a bug:
+    # fall back to the default backends, but say so.
+    try:
+        autotune()
+    except Exception as e:
+        set_backend("auto")
+        warnings.warn(f"fd58: autotune failed ({e!r}), using the default backends", RuntimeWarning)
@@ -1,28 +1,13 @@
 /* Original source:
    https://github.com/firedancer-io/firedancer/blob/main/src/ballet/base58/fd_base58.c */
 
-#include "fd_base58.h"
-#include <stdint.h>
-#include <string.h>
+#include "fd_base58_private.h"
 
-#define FD_STRINGIFY(x)#x
-#define FD_CONCAT2(a,b)a##b
-#define FD_CONCAT3(a,b,c)a##b##c
-#define FD_CONCAT4(a,b,c,d)a##b##c##d
+#if FD_HAS_X86
+#include "fd_base58_sse.h"
+#endif
 
-#define FD_EXPAND_THEN_STRINGIFY(x)FD_STRINGIFY(x)
-#define FD_EXPAND_THEN_CONCAT2(a,b)FD_CONCAT2(a,b)
-#define FD_EXPAND_THEN_CONCAT3(a,b,c)FD_CONCAT3(a,b,c)
-#define FD_EXPAND_THEN_CONCAT4(a,b,c,d)FD_CONCAT4(a,b,c,d)
-
-#define FD_LIKELY(c)   __builtin_expect( !!(c), 1L )
-#define FD_UNLIKELY(c) __builtin_expect( !!(c), 0L )
-
-static char const base58_chars[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-
-#define BASE58_INVALID_CHAR           ((uint8_t)255)
-#define BASE58_INVERSE_TABLE_OFFSET   ((uint8_t)'1')
-#define BASE58_INVERSE_TABLE_SENTINEL ((uint8_t)(1UL + (uint8_t)('z')-BASE58_INVERSE_TABLE_OFFSET))
+char const base58_chars[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
 
 /* base58_inverse maps (character value - '1') to [0, 58).  Invalid
    base58 characters map to BASE58_INVALID_CHAR.  The character after
@@ -45,51 +30,22 @@ uint8_t const base58_inverse[] = {
 
 #undef BAD
 
-#define N                32
-#define INTERMEDIATE_SZ (9UL) /* Computed by ceil(log_(58^5) (256^32-1)) */
-#define BINARY_SZ       ((uint64_t)N/4UL)
-
-/* Contains the unique values less than 58^5 such that:
-     2^(32*(7-j)) = sum_k table[j][k]*58^(5*(7-k))
+/* Conversion tables.  enc_table_64 contains the unique values less
+   than 58^5 such that:
+     2^(32*(15-j)) = sum_k table[j][k]*58^(5*(16-k))
 
    The second dimension of this table is actually ceil(log_(58^5)
-   (2^(32*(BINARY_SZ-1))), but that's almost always INTERMEDIATE_SZ-1 */
-
-static uint32_t const enc_table_32[BINARY_SZ][INTERMEDIATE_SZ-1UL] = {
-  {   513735U,  77223048U, 437087610U, 300156666U, 605448490U, 214625350U, 141436834U, 379377856U},
-  {        0U,     78508U, 646269101U, 118408823U,  91512303U, 209184527U, 413102373U, 153715680U},
-  {        0U,         0U,     11997U, 486083817U,   3737691U, 294005210U, 247894721U, 289024608U},
-  {        0U,         0U,         0U,      1833U, 324463681U, 385795061U, 551597588U,  21339008U},
-  {        0U,         0U,         0U,         0U,       280U, 127692781U, 389432875U, 357132832U},
-  {        0U,         0U,         0U,         0U,         0U,        42U, 537767569U, 410450016U},
-  {        0U,         0U,         0U,         0U,         0U,         0U,         6U, 356826688U},
-  {        0U,         0U,         0U,         0U,         0U,         0U,         0U,         1U}
-};
-
-/* Contains the unique values less than 2^32 such that:
-     58^(5*(8-j)) = sum_k table[j][k]*2^(32*(7-k)) */
-
-static uint32_t const dec_table_32[INTERMEDIATE_SZ][BINARY_SZ] = {
-  {      1277U, 2650397687U, 3801011509U, 2074386530U, 3248244966U,  687255411U, 2959155456U,          0U},
-  {         0U,       8360U, 1184754854U, 3047609191U, 3418394749U,  132556120U, 1199103528U,          0U},
-  {         0U,          0U,      54706U, 2996985344U, 1834629191U, 3964963911U,  485140318U, 1073741824U},
-  {         0U,          0U,          0U,     357981U, 1476998812U, 3337178590U, 1483338760U, 4194304000U},
-  {         0U,          0U,          0U,          0U,    2342503U, 3052466824U, 2595180627U,   17825792U},
-  {         0U,          0U,          0U,          0U,          0U,   15328518U, 1933902296U, 4063920128U},
-  {         0U,          0U,          0U,          0U,          0U,          0U,  100304420U, 3355157504U},
-  {         0U,          0U,          0U,          0U,          0U,          0U,          0U,  656356768U},
-  {         0U,          0U,          0U,          0U,          0U,          0U,          0U,          1U}
-};
-#include "fd_base58_tmpl.h"
+   (2^(32*(BINARY_SZ-1))), but that's almost always INTERMEDIATE_SZ-1.
 
-#define N                64
-#define INTERMEDIATE_SZ (18UL) /* Computed by ceil(log_(58^5) (256^64-1)) */
-#define BINARY_SZ       ((uint64_t)N/4UL)
+   dec_table_64 contains the unique values less than 2^32 such that:
+     58^(5*(17-j)) = sum_k table[j][k]*2^(32*(15-k))
 
-/* Contains the unique values less than 58^5 such that
-   2^(32*(15-j)) = sum_k table[j][k]*58^(5*(16-k)) */
+   The tables for N==32 are the bottom right corners of these (see
+   enc_table_32 and dec_table_32 in fd_base58_private.h), so the two
+   sizes share one copy.  Both start on a cache line.  Entries left of
+   the diagonal are zero and the loops in fd_base58_tmpl.h skip them. */
 
-static uint32_t const enc_table_64[BINARY_SZ][INTERMEDIATE_SZ-1UL] = {
+uint32_t const enc_table_64[ 16 ][ 17 ] __attribute__((aligned(64))) = {
   {     2631U, 149457141U, 577092685U, 632289089U,  81912456U, 221591423U, 502967496U, 403284731U, 377738089U, 492128779U,    746799U, 366351977U, 190199623U,  38066284U, 526403762U, 650603058U, 454901440U},
   {        0U,       402U,  68350375U,  30641941U, 266024478U, 208884256U, 571208415U, 337765723U, 215140626U, 129419325U, 480359048U, 398051646U, 635841659U, 214020719U, 136986618U, 626219915U,  49699360U},
   {        0U,         0U,        61U, 295059608U, 141201404U, 517024870U, 239296485U, 527697587U, 212906911U, 453637228U, 467589845U, 144614682U,  45134568U, 184514320U, 644355351U, 104784612U, 308625792U},
@@ -108,7 +64,7 @@ static uint32_t const enc_table_64[BINARY_SZ][INTERMEDIATE_SZ-1UL] = {
   {        0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         0U,         1U}
 };
 
-static uint32_t const dec_table_64[INTERMEDIATE_SZ][BINARY_SZ] = {
+uint32_t const dec_table_64[ 18 ][ 16 ] __attribute__((aligned(64))) = {
   {    249448U, 3719864065U,  173911550U, 4021557284U, 3115810883U, 2498525019U, 1035889824U,  627529458U, 3840888383U, 3728167192U, 2901437456U, 3863405776U, 1540739182U, 1570766848U,          0U,          0U},
   {         0U,    1632305U, 1882780341U, 4128706713U, 1023671068U, 2618421812U, 2005415586U, 1062993857U, 3577221846U, 3960476767U, 1695615427U, 2597060712U,  669472826U,  104923136U,          0U,          0U},
   {         0U,          0U,   10681231U, 1422956801U, 2406345166U, 4058671871U, 2143913881U, 4169135587U, 2414104418U, 2549553452U,  997594232U,  713340517U, 2290070198U, 1103833088U,          0U,          0U},
@@ -129,4 +85,650 @@ static uint32_t const dec_table_64[INTERMEDIATE_SZ][BINARY_SZ] = {
   {         0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          1U}
 };
 
+#define KERNEL scalar
+
+#define N                32
+#define INTERMEDIATE_SZ (9UL) /* Computed by ceil(log_(58^5) (256^32-1)) */
+#define BINARY_SZ       ((uint64_t)N/4UL)
+
+#include "fd_base58_tmpl.h"
+
+#define N                64
+#define INTERMEDIATE_SZ (18UL) /* Computed by ceil(log_(58^5) (256^64-1)) */
+#define BINARY_SZ       ((uint64_t)N/4UL)
+
 #include "fd_base58_tmpl.h"
+
+/* Backends.  Each op (see FD_BASE58_OP_*) is bound to one of these on
+   first use, and can be rebound with fd_base58_set_backend.  Listed in
+   order of preference: the default for an op is the first backend the
+   CPU running this code supports.  avx512 is avx2 plus the AVX-512
+   batch kernels, which convert 8 inputs at once; the other backends
+   have no batch kernels and run the batch conversions one input at a
+   time on their own kernels.  ifma implies avx512, so it is only used
+   when asked for.  wide only needs unsigned __int128 and is usually
+   ahead of scalar, which stays as the portable reference. */
+
+typedef char *          (*fd_base58_encode_fn_t)      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+typedef unsigned char * (*fd_base58_decode_fn_t)      ( char const * encoded, unsigned char * out );
+typedef unsigned char * (*fd_base58_decode_len_fn_t)  ( char const * encoded, unsigned long len, unsigned char * out );
+typedef char *          (*fd_base58_encode_batch_fn_t)( unsigned char const * bytes, unsigned long cnt, unsigned * opt_len, char * out );
+typedef unsigned long   (*fd_base58_decode_batch_fn_t)( char const * const * encoded, unsigned long cnt, unsigned char * out, unsigned char * opt_valid );
+
+typedef struct {
+  char const *                name;
+  int                         (*supported)( void );
+  fd_base58_encode_fn_t       encode_32;
+  fd_base58_encode_fn_t       encode_64;
+  fd_base58_decode_fn_t       decode_32;
+  fd_base58_decode_fn_t       decode_64;
+  fd_base58_decode_len_fn_t   decode_32_len;
+  fd_base58_decode_len_fn_t   decode_64_len;
+  fd_base58_encode_batch_fn_t encode_32_batch; /* NULL if the backend has no batch kernels */
+  fd_base58_encode_batch_fn_t encode_64_batch;
+  fd_base58_decode_batch_fn_t decode_32_batch;
+  fd_base58_decode_batch_fn_t decode_64_batch;
+} fd_base58_backend_t;
+
+#if FD_HAS_X86
+static int fd_base58_has_avx2( void ) { return __builtin_cpu_supports( "avx2" ); }
+
+static int
+fd_base58_has_avx512( void ) {
+  return __builtin_cpu_supports( "avx2"     ) && __builtin_cpu_supports( "avx512f"  ) &&
+         __builtin_cpu_supports( "avx512dq" ) && __builtin_cpu_supports( "avx512bw" ) &&
+         __builtin_cpu_supports( "avx512cd" );
+}
+
+static int fd_base58_has_ifma( void ) { return fd_base58_has_avx512() && __builtin_cpu_supports( "avx512ifma" ); }
+#endif
+
+#if FD_HAS_X86 && FD_HAS_INT128
+static int fd_base58_has_adx( void ) { return __builtin_cpu_supports( "bmi2" ) && __builtin_cpu_supports( "adx" ); }
+#endif
+
+#if FD_HAS_INT128
+static int fd_base58_has_wide( void ) { return 1; }
+#endif
+
+static int fd_base58_has_scalar( void ) { return 1; }
+
+#define KERNELS(k) fd_base58_encode_32_##k,     fd_base58_encode_64_##k,     \
+                   fd_base58_decode_32_##k,     fd_base58_decode_64_##k,     \
+                   fd_base58_decode_32_len_##k, fd_base58_decode_64_len_##k
+
+#define BACKEND(k)               { #k, fd_base58_has_##k, KERNELS(k), NULL, NULL, NULL, NULL }
+#define BACKEND_BATCH(k,single)  { #k, fd_base58_has_##k, KERNELS(single),                                     \
+                                   fd_base58_encode_32_batch_##k, fd_base58_encode_64_batch_##k,               \
+                                   fd_base58_decode_32_batch_##k, fd_base58_decode_64_batch_##k }
+
+static fd_base58_backend_t const fd_base58_backends[] = {
+#if FD_HAS_X86
+  BACKEND_BATCH( avx512, avx2 ),
+  BACKEND( avx2 ),
+  BACKEND( ifma ),
+#endif
+#if FD_HAS_X86 && FD_HAS_INT128
+  BACKEND( adx ),
+#endif
+#if FD_HAS_INT128
+  BACKEND( wide ),
+#endif
+  BACKEND( scalar )
+};
+
+#undef BACKEND_BATCH
+#undef BACKEND
+#undef KERNELS
+
+#define BACKEND_CNT (sizeof(fd_base58_backends)/sizeof(fd_base58_backends[0]))
+
+/* fd_base58_bound[op] is the backend op is bound to, NULL until first
+   use.  Accesses are atomic so that rebinding is safe while other
+   threads convert, but relaxed, since the backends are immutable. */
+
+static fd_base58_backend_t const * fd_base58_bound[ FD_BASE58_OP_CNT ];
+
+static fd_base58_backend_t const *
+fd_base58_backend_default( void ) {
+  for( unsigned long i=0UL; i<BACKEND_CNT; i++ )
+    if( fd_base58_backends[ i ].supported() ) return &fd_base58_backends[ i ];
+  return &fd_base58_backends[ BACKEND_CNT-1UL ]; /* scalar, always supported */
+}
+
+static inline fd_base58_backend_t const *
+fd_base58_backend_query( int op ) {
+  fd_base58_backend_t const * b = __atomic_load_n( &fd_base58_bound[ op ], __ATOMIC_RELAXED );
+  if( FD_UNLIKELY( !b ) ) {
+    b = fd_base58_backend_default();
+    __atomic_store_n( &fd_base58_bound[ op ], b, __ATOMIC_RELAXED );
+  }
+  return b;
+}
+
+char const *
+fd_base58_backend_name( unsigned long idx ) {
+  for( unsigned long i=0UL; i<BACKEND_CNT; i++ ) {
+    if( !fd_base58_backends[ i ].supported() ) continue;
+    if( !idx-- ) return fd_base58_backends[ i ].name;
+  }
+  return NULL;
+}
+
+char const *
+fd_base58_backend( int op ) {
+  if( op>=FD_BASE58_OP_CNT ) return NULL;
+  if( op>=0 ) return fd_base58_backend_query( op )->name;
+  fd_base58_backend_t const * b = fd_base58_backend_query( 0 );
+  for( int i=1; i<FD_BASE58_OP_CNT; i++ ) if( fd_base58_backend_query( i )!=b ) return "mixed";
+  return b->name;
+}
+
+int
+fd_base58_set_backend( char const * name,
+                       int          op ) {
+  if( !name || op>=FD_BASE58_OP_CNT ) return -1;
+
+  fd_base58_backend_t const * b = NULL;
+  if( !strcmp( name, "auto" ) ) b = fd_base58_backend_default();
+  for( unsigned long i=0UL; !b && i<BACKEND_CNT; i++ )
+    if( !strcmp( name, fd_base58_backends[ i ].name ) && fd_base58_backends[ i ].supported() ) b = &fd_base58_backends[ i ];
+  if( !b ) return -1;
+
+  for( int i=0; i<FD_BASE58_OP_CNT; i++ )
+    if( op<0 || op==i ) __atomic_store_n( &fd_base58_bound[ i ], b, __ATOMIC_RELAXED );
+  return 0;
+}
+
+#undef BACKEND_CNT
+
+/* Public entry points.  These forward to the bound backend. */
+
+char *
+fd_base58_encode_32( unsigned char const * bytes,
+                     unsigned            * opt_len,
+                     char                * out ) {
+  return fd_base58_backend_query( FD_BASE58_OP_ENCODE_32 )->encode_32( bytes, opt_len, out );
+}
+
+char *
+fd_base58_encode_64( unsigned char const * bytes,
+                     unsigned            * opt_len,
+                     char                * out ) {
+  return fd_base58_backend_query( FD_BASE58_OP_ENCODE_64 )->encode_64( bytes, opt_len, out );
+}
+
+unsigned char *
+fd_base58_decode_32( char const *    encoded,
+                     unsigned char * out ) {
+  return fd_base58_backend_query( FD_BASE58_OP_DECODE_32 )->decode_32( encoded, out );
+}
+
+unsigned char *
+fd_base58_decode_64( char const *    encoded,
+                     unsigned char * out ) {
+  return fd_base58_backend_query( FD_BASE58_OP_DECODE_64 )->decode_64( encoded, out );
+}
+
+/* The length-aware decodes have kernels of their own, which read the
+   input in place (see fd_base58_tmpl.h), bound with the cstr ones. */
+
+unsigned char *
+fd_base58_decode_32_len( char const *    encoded,
+                         unsigned long   len,
+                         unsigned char * out ) {
+  return fd_base58_backend_query( FD_BASE58_OP_DECODE_32 )->decode_32_len( encoded, len, out );
+}
+
+unsigned char *
+fd_base58_decode_64_len( char const *    encoded,
+                         unsigned long   len,
+                         unsigned char * out ) {
+  return fd_base58_backend_query( FD_BASE58_OP_DECODE_64 )->decode_64_len( encoded, len, out );
+}
+
+/* fd_base58_decode_err works out why the kernels rejected the len
+   characters at encoded.  They fail on the first of these checks that
+   doesn't pass, in this order, so whatever is left after the length,
+   character and overflow checks is a leading '1' mismatch.  The
+   overflow check redoes the conversion a digit at a time into byte_cnt
+   bytes, which is slow but only runs for invalid inputs. */
+
+static int
+fd_base58_decode_err( char const *    encoded,
+                      unsigned long   len,
+                      unsigned long   byte_cnt,
+                      unsigned long   max_len,
+                      unsigned long * opt_err_off ) {
+  unsigned long err_off = 0UL;
+  int           err     = FD_BASE58_ERR_LEADING_ONES;
+
+  if( len>max_len ) {
+    err_off = max_len;
+    err     = FD_BASE58_ERR_LEN;
+    goto done;
+  }
+
+  for( unsigned long i=0UL; i<len; i++ ) {
+    uint64_t idx = (uint64_t)(uint8_t)encoded[ i ] - (uint64_t)BASE58_INVERSE_TABLE_OFFSET;
+    idx = idx<BASE58_INVERSE_TABLE_SENTINEL ? idx : BASE58_INVERSE_TABLE_SENTINEL;
+    if( base58_inverse[ idx ]==BASE58_INVALID_CHAR ) {
+      err_off = i;
+      err     = FD_BASE58_ERR_CHAR;
+      goto done;
+    }
+  }
+
+  uint8_t num[ 64 ] = { 0 };
+  for( unsigned long i=0UL; i<len; i++ ) {
+    uint32_t carry = base58_inverse[ (uint8_t)encoded[ i ] - BASE58_INVERSE_TABLE_OFFSET ];
+    for( unsigned long j=byte_cnt; j>0UL; j-- ) {
+      uint32_t t = (uint32_t)num[ j-1UL ]*58U + carry;
+      num[ j-1UL ] = (uint8_t)t;
+      carry        = t>>8;
+    }
+    if( carry ) {
+      err = FD_BASE58_ERR_OVERFLOW;
+      goto done;
+    }
+  }
+
+done:
+  if( opt_err_off ) *opt_err_off = err_off;
+  return err;
+}
+
+int
+fd_base58_decode_32_ex( char const *    encoded,
+                        unsigned long   len,
+                        unsigned char * out,
+                        unsigned long * opt_err_off ) {
+  if( FD_LIKELY( fd_base58_decode_32_len( encoded, len, out ) ) ) return FD_BASE58_SUCCESS;
+  return fd_base58_decode_err( encoded, len, 32UL, FD_BASE58_ENCODED_32_LEN, opt_err_off );
+}
+
+int
+fd_base58_decode_64_ex( char const *    encoded,
+                        unsigned long   len,
+                        unsigned char * out,
+                        unsigned long * opt_err_off ) {
+  if( FD_LIKELY( fd_base58_decode_64_len( encoded, len, out ) ) ) return FD_BASE58_SUCCESS;
+  return fd_base58_decode_err( encoded, len, 64UL, FD_BASE58_ENCODED_64_LEN, opt_err_off );
+}
+
+char const *
+fd_base58_strerror( int err ) {
+  switch( err ) {
+  case FD_BASE58_SUCCESS:          return "success";
+  case FD_BASE58_ERR_LEN:          return "too long";
+  case FD_BASE58_ERR_CHAR:         return "invalid character";
+  case FD_BASE58_ERR_OVERFLOW:     return "value too large";
+  case FD_BASE58_ERR_LEADING_ONES: return "leading '1's don't match leading zero bytes";
+  default:                         return "unknown error";
+  }
+}
+
+/* Tables for fd_base58_encoded_len_{32,64}.  bit_cnt_digits[ b ] is the
+   number of base58 digits in 2^b-1, the largest b bit number.  pow58[ k ]
+   is 58^k as 8 limbs, most significant first.  Powers below 2^256 fit in
+   the last 4 limbs, which are what the 32 byte version looks at. */
+
+static uint8_t const bit_cnt_digits[ 513 ] = {
+   0,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,  3,  4,  4,  4,  4,  4,  4,
+   5,  5,  5,  5,  5,  5,  6,  6,  6,  6,  6,  6,  7,  7,  7,  7,  7,  7,  8,  8,  8,  8,  8,  9,
+   9,  9,  9,  9,  9, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 13,
+  13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 16, 16, 16, 16, 16, 16, 17, 17,
+  17, 17, 17, 17, 18, 18, 18, 18, 18, 18, 19, 19, 19, 19, 19, 19, 20, 20, 20, 20, 20, 20, 21, 21,
+  21, 21, 21, 21, 22, 22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 24, 24, 24, 24, 24, 24, 25, 25, 25,
+  25, 25, 25, 26, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27, 27, 28, 28, 28, 28, 28, 28, 29, 29, 29,
+  29, 29, 30, 30, 30, 30, 30, 30, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 33, 33, 33, 33,
+  33, 33, 34, 34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 35, 36, 36, 36, 36, 36, 37, 37, 37, 37, 37,
+  37, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 40, 40, 40, 40, 40, 40, 41, 41, 41, 41, 41,
+  41, 42, 42, 42, 42, 42, 42, 43, 43, 43, 43, 43, 44, 44, 44, 44, 44, 44, 45, 45, 45, 45, 45, 45,
+  46, 46, 46, 46, 46, 46, 47, 47, 47, 47, 47, 47, 48, 48, 48, 48, 48, 48, 49, 49, 49, 49, 49, 49,
+  50, 50, 50, 50, 50, 51, 51, 51, 51, 51, 51, 52, 52, 52, 52, 52, 52, 53, 53, 53, 53, 53, 53, 54,
+  54, 54, 54, 54, 54, 55, 55, 55, 55, 55, 55, 56, 56, 56, 56, 56, 56, 57, 57, 57, 57, 57, 58, 58,
+  58, 58, 58, 58, 59, 59, 59, 59, 59, 59, 60, 60, 60, 60, 60, 60, 61, 61, 61, 61, 61, 61, 62, 62,
+  62, 62, 62, 62, 63, 63, 63, 63, 63, 63, 64, 64, 64, 64, 64, 65, 65, 65, 65, 65, 65, 66, 66, 66,
+  66, 66, 66, 67, 67, 67, 67, 67, 67, 68, 68, 68, 68, 68, 68, 69, 69, 69, 69, 69, 69, 70, 70, 70,
+  70, 70, 70, 71, 71, 71, 71, 71, 72, 72, 72, 72, 72, 72, 73, 73, 73, 73, 73, 73, 74, 74, 74, 74,
+  74, 74, 75, 75, 75, 75, 75, 75, 76, 76, 76, 76, 76, 76, 77, 77, 77, 77, 77, 77, 78, 78, 78, 78,
+  78, 79, 79, 79, 79, 79, 79, 80, 80, 80, 80, 80, 80, 81, 81, 81, 81, 81, 81, 82, 82, 82, 82, 82,
+  82, 83, 83, 83, 83, 83, 83, 84, 84, 84, 84, 84, 84, 85, 85, 85, 85, 85, 86, 86, 86, 86, 86, 86,
+  87, 87, 87, 87, 87, 87, 88, 88, 88
+};
+
+static uint64_t const pow58[ 88 ][ 8 ] __attribute__((aligned(64))) = {
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000001UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000000003aUL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000d24UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000002fa28UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000acad10UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000271f35a0UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000008dd122640UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000202161caa80UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00007479027ea100UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x001a636a90b07a00UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x05fa8624c7fba400UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000001UL, 0x5ac264554f032800UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000000004eUL, 0x900abb53e6b71000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000000011ccUL, 0xa26e71024579a000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000004085cUL, 0xcd059a83bd8e4000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000e9e506UL, 0x734501d8f23a8000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000034fde376UL, 0x1da26b26e1410000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000c018588c2UL, 0xb6cc46cf08ba0000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000002b85840fc1dUL, 0x6a480ae7fa240000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00009dc3feb91eaaUL, 0x1452788eac280000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0023be67b5f0f288UL, 0x9aaf505301100000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0819237f3896f2f3UL, 0x0bb832ce3da00000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000001UL, 0xd5b20ad2d2330b10UL, 0xa7bb82b9f6400000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000000006aUL, 0x6a5673c39f9081c6UL, 0x007b9e21ca800000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000000181cUL, 0x17963a5226bd66dcUL, 0x1c01d3a7e1000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000005765dUL, 0x5809369cc6e94ddeUL, 0x5869f408fa000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000013cd125UL, 0xf2165f8510dba460UL, 0x08014a08a4000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000047c76298UL, 0xd911a425d1c33dc1UL, 0xd04ac5f528000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000010432c56a1UL, 0x2dff3091863bfde9UL, 0x30f0d98b10000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000003af380ba084UL, 0x6bd100f8699786d5UL, 0x16914981a0000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000d5b2b2a25e00UL, 0x6d5a3847ec548c47UL, 0x1ceaa75e40000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00306a7c78c94c18UL, 0xc670c04b8b27c81cUL, 0x8d29eb5a80000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0af820335d9b3d9cUL, 0xf58b911d87035677UL, 0xfb7f528100000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000002UL, 0x7c374ba3352bf58fUL, 0xa19ee0b096c1972eUL, 0xfad8b13a00000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000090UL, 0x248722fa0bf5a28aUL, 0x9dfee80227dc40a4UL, 0xd518272400000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000000020a8UL, 0x469deca6b5a6d367UL, 0xcbc0907d07e6a558UL, 0x4778de2800000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000000007661fUL, 0xffc79dc527cbe584UL, 0x29a0bc53ca417600UL, 0x3162551000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000001ad233fUL, 0xf339beab0431fff1UL, 0x6e6aaafbd2d4bc0bUL, 0x304745a000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000000006139fc7dUL, 0x1b1532bef353fcb3UL, 0x042abd0dc4329a88UL, 0xf025c64000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000001607233458UL, 0x22cd7f432107408eUL, 0xf1aed51e73770306UL, 0x688eea8000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000004fd9df9dbf7UL, 0xe28ed5357ba4a062UL, 0xc19c48e628f6af73UL, 0xb061210000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00012175ca9bd629UL, 0x545c4e1e034c565fUL, 0xdd68842547e3c035UL, 0xf6017a0000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x004194afe74e855dUL, 0x1ce9b2ccbf4b91b8UL, 0x29adf07249998c39UL, 0xbc55a40000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0edbafda67ca3718UL, 0x8cf28263571f03b9UL, 0x716879e4acc9c514UL, 0xab67280000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000003UL, 0x5dc5d77b83d07b8fUL, 0xeef18a81bd06d803UL, 0xb1ab9dcf25b6a6aeUL, 0xd55f100000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000000000c3UL, 0x3ed2d1fbdd3bfe9cUL, 0x22b96164d38cf0d6UL, 0x40e1c0ee8b61c39cUL, 0x5789a00000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000002c3cUL, 0x3bc393101f97af5fUL, 0xde0010d7edee908aUL, 0xb325b60b9426516bUL, 0xd52e400000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000000a05a5UL, 0x8a4f51a7285dbbb8UL, 0x4c03d0ebe80cbf6cUL, 0x968b3e9f90ae726eUL, 0x4c7a800000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000002454781UL, 0x55f87fdf253c87c1UL, 0x38dd557292e35e9aUL, 0x1b8c3026c785ecfdUL, 0x53c1000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000083b2334dUL, 0x7a4cf88e6fb6c1c6UL, 0xe2255bf547836eeaUL, 0x3dc2e8c93457b164UL, 0xf9ba000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0000001dd65f9f8dUL, 0xb57050454f67e70fUL, 0x3c76d59233c72111UL, 0xfe28bd95dbde30e0UL, 0x9424000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x000006c291aa261bUL, 0x1b722fb3fd8a5973UL, 0xb2ec631fbb1d7e13UL, 0x953af3f3d05712e1UL, 0x9028000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x00018815008ca224UL, 0x37decec771584436UL, 0x898e753064ae906fUL, 0xcf5b453d33ba471aUL, 0xa910000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x0058d4c21fdcbc34UL, 0xa87ad92fadff745bUL, 0x2a468cf6cf8cb954UL, 0xfaadafddb8341c0aUL, 0x4da0000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000000UL, 0x142033fb3802a3eeUL, 0x2bd534cd6be05ca7UL, 0x93fbefeb05e1fd40UL, 0xcb59d83bbbce5a55UL, 0x9640000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000004UL, 0x8f4bc6eab09923f5UL, 0xee4df68a70d4fdf7UL, 0x87145b3f553360aeUL, 0x125afd888cc07764UL, 0x0a80000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000000108UL, 0x772b112c02b225b7UL, 0xfda9db5d90418a14UL, 0x9a9cac594da3e770UL, 0x289d70efe39b0caaUL, 0x6100000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000000003beaUL, 0xffc1e3f89c5c8bafUL, 0x787bb332aed948abUL, 0x077f0c3b97226f69UL, 0x33ab96599120de99UL, 0xfa00000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000000d933dUL, 0xf1eda6536cf7a5c1UL, 0x4c06997b9d3a76bfUL, 0xb2c8c5803dcd3dd5UL, 0xb4e0104ae1726ee2UL, 0xa400000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x0000000003135c08UL, 0xcfd7aee6b01b8dcbUL, 0x397ec6019f3ee76eUL, 0x817cbf0e0080026aUL, 0xfac3b0f713ed1f59UL, 0x2800000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x00000000b262d9ffUL, 0x16dda043e63e200bUL, 0x06b8dc5e14406f09UL, 0x5643492c1d008c3cUL, 0xd05617fa83b91a33UL, 0x1000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x000000286a6563cbUL, 0x2e364f622a13427fUL, 0x85e1ed509699281dUL, 0x8b3e93fe921fc5c7UL, 0x33816ec1d7efef91UL, 0xa000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x000009281af89c08UL, 0x784dfc3d885d10e4UL, 0x552fc4421eb316b1UL, 0x8c2d87ad1b32cf21UL, 0xab5317eaec5c46feUL, 0x4000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x000213161c5359ebUL, 0x41ab25f0e515d3bbUL, 0x4cd276faf4932439UL, 0xc250bd382982eda0UL, 0xd0d36b398ce8159aUL, 0x8000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x007853026ae25f4cUL, 0xe0c69893e6f1f86fUL, 0x67aef4db69563516UL, 0x064adeb967a9d66fUL, 0x4fe64b09ec94e501UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000000UL, 0x1b42ce8c3749976aUL, 0xecfe918252d2493dUL, 0x7da379b5dd8806fdUL, 0x6cf676017c7a9538UL, 0x1a2d003f99bbe23aUL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000006UL, 0x2d22cbc486ac4e39UL, 0xb1acf786c3a497eeUL, 0x7709933430d1956aUL, 0xafd6bc5633c5ceb5UL, 0xee320e68d4914124UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000000166UL, 0x39e22a868309b912UL, 0x41301488534a6c06UL, 0xf82b59d30f7bda2bUL, 0xd6a6ab87bad0d537UL, 0xf75743c028e8c228UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000005129UL, 0x1d3da279b033ee22UL, 0xc4e4a6e2dedc7994UL, 0x39d259d1820f6deeUL, 0xa1c2dcc053504eaeUL, 0x09c5598944bbfd10UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x0000000000126350UL, 0x9ff6cf91ebc3f3e0UL, 0x9bcdcf667df38b95UL, 0x19a85977777ee810UL, 0xa6260392e031d36eUL, 0x36b64919929755a0UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x00000000042a8044UL, 0x3deb070f6a6540e3UL, 0x4ca0fd38892d9fc7UL, 0xd024451112c093c5UL, 0xa49ccf46cb49e6f8UL, 0x654c8fcb36496640UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x00000000f1a10f76UL, 0x073f997e1af0b37fUL, 0x5c795ecf14563345UL, 0x2837a5de3fa17ac7UL, 0x4b86f60a0ebe5446UL, 0xf358940a4ca12a80UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x00000036be7d80bdUL, 0xa468c6921a88aadaUL, 0xf37f7aea9b879dabUL, 0x1c9b945a6a95d127UL, 0x1c93be47571f1813UL, 0x22118a555c83a100UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x00000c67286f2af7UL, 0x3fbcfd1a02f6b59bUL, 0x2ae1d9273cb9b8c4UL, 0x7b3f9c7c25f162dcUL, 0x79791c29bd0b7455UL, 0xb7f95756f5d27a00UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x0002cf5f292fbc04UL, 0x70d157e4abe52527UL, 0xb72b32e3c213dc83UL, 0xec69742098b065f3UL, 0x85706174d4985b6bUL, 0xae7dc9b3b1afa400UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x00a2fb8f54d09901UL, 0x8f6de9cef1ea6affUL, 0x7fc98799f87ff5e3UL, 0x8fe44f6297f7192cUL, 0x3b7614782a84b665UL, 0x887fb2b641cb2800UL, 0x0000000000000000UL },
+  { 0x0000000000000000UL, 0x24ecfe793742aa5aUL, 0x7ee6f8e2cf1c3de2UL, 0xf3a8b8e24cfdb58eUL, 0x99b9fc566dfbb405UL, 0x78c0a339a2115300UL, 0xecee7d4ae8071000UL, 0x0000000000000000UL },
+  { 0x0000000000000008UL, 0x5db1a776851a9880UL, 0xc0546362ec66056bUL, 0x3439e345717b224eUL, 0xd4232b94eb06c93dUL, 0x5ba4fb0eb7ecce35UL, 0xae0862f89199a000UL, 0x0000000000000000UL },
+  { 0x00000000000001e5UL, 0x3a3ff0da28068d2bUL, 0x931e84698f1d3a49UL, 0xd51d7dbbb5e5c5dcUL, 0x0ff7dfbd3f8997e6UL, 0xc360e155aba6b829UL, 0x6de66c50fcce4000UL, 0x0000000000000000UL },
+  { 0x0000000000006defUL, 0x327c916d117bfbdfUL, 0x54e9ffea6c9f34baUL, 0x48ae7c87360ed3dbUL, 0x9e28b0e0652c6a48UL, 0x43f30d68e3c5b962UL, 0xe6348a5946ba8000UL, 0x0000000000000000UL },
+  { 0x000000000018e831UL, 0x7038f2b5f6171099UL, 0x3d03fb1c9c11f234UL, 0x778836a23f5bffc1UL, 0xd53812d6ec10145fUL, 0x651109c39acc0068UL, 0x27e7583a06410000UL, 0x0000000000000000UL },
+  { 0x0000000005a49b33UL, 0x6ce6fd39c139c2b7UL, 0xd2e6e47b5c10dfe3UL, 0x14dc60c25ad7f1eaUL, 0x4eb444b17ba49d9cUL, 0xe5dc365112381799UL, 0x0a69fd256aba0000UL, 0x0000000000000000UL },
+  { 0x00000001474b29a6UL, 0xac555f15c7161da5UL, 0xc84fc3f2dbd2b972UL, 0xb9edec0894eccf15UL, 0xd4d79036034bb58cUL, 0x13e44e5e20b558acUL, 0x5c035a7a2e240000UL, 0x0000000000000000UL },
+  { 0x0000004a27076fc3UL, 0x0b578aef1b02b78fUL, 0x62126505cdbe03feUL, 0x1fe779f1bda6eaf2UL, 0x38d6ac3cbf2721bcUL, 0x81b9c1536916170cUL, 0xd8c27fae74280000UL, 0x0000000000000000UL },
+  { 0x000010ccd7af5230UL, 0x91d57a2c1e9d967cUL, 0x382ae3509d0ce793UL, 0x3a71a0c4f7d13ae0UL, 0xe0a305c34edda4b5UL, 0x6415cce5cf0138e9UL, 0x1c10ed8651100000UL, 0x0000000000000000UL },
+  { 0x0003ce68ddb89f01UL, 0x0a5dadfeefb41824UL, 0xb9b7804394ec775bUL, 0x3dbe6ca0256756f2UL, 0xe4ef4e3fde375118UL, 0xacf06c10e646e4d0UL, 0x5bd5d06e5da00000UL, 0x0000000000000000UL },
+  { 0x00dcc3c23bd4063cUL, 0x59396bc24ecd7852UL, 0x13930f4fbd930aabUL, 0xfd249c487969b307UL, 0xde37ba7858885f97UL, 0x2e787bd42c0fd734UL, 0xce71390136400000UL, 0x0000000000000000UL },
+  { 0x32045a018e0969acUL, 0x37026a05da8d4298UL, 0x6f517810f3506af7UL, 0x5a4b686b81f28fc8UL, 0x58a03f440ee5a840UL, 0x874c0e11fb96c1f6UL, 0xc5a6ea464a800000UL, 0x0000000000000000UL }
+};
+
+/* A nonzero number of b bits has at least bit_cnt_digits[ b-1 ] digits
+   and at most bit_cnt_digits[ b ].  When those differ, the power of 58
+   in between also has b bits, so it is the only threshold to compare
+   against, and only from the first nonzero limb on.  Each leading zero
+   byte becomes a '1' on top. */
+
+static inline unsigned long
+fd_base58_encoded_len( unsigned char const * bytes,
+                       uint64_t              limb_cnt ) {
+  uint64_t limb[ 8 ];
+  for( uint64_t i=0UL; i<limb_cnt; i++ ) {
+    memcpy( limb+i, bytes+8UL*i, sizeof(uint64_t) );
+    limb[ i ] = __builtin_bswap64( limb[ i ] );
+  }
+
+  uint64_t i = 0UL;
+  while( i<limb_cnt && !limb[ i ] ) i++;
+  if( FD_UNLIKELY( i==limb_cnt ) ) return 8UL*limb_cnt;
+
+  uint64_t lz_bits  = 64UL*i + (uint64_t)__builtin_clzll( limb[ i ] );
+  uint64_t bit_cnt  = 64UL*limb_cnt - lz_bits;
+  uint64_t digits   = bit_cnt_digits[ bit_cnt-1UL ];
+  if( digits!=bit_cnt_digits[ bit_cnt ] ) {
+    uint64_t const * pow = pow58[ digits ] + 8UL-limb_cnt;
+    int ge = 1;
+    for( ; i<limb_cnt; i++ ) if( limb[ i ]!=pow[ i ] ) { ge = limb[ i ]>pow[ i ]; break; }
+    digits += (uint64_t)ge;
+  }
+  return lz_bits/8UL + digits;
+}
+
+unsigned long fd_base58_encoded_len_32( unsigned char const * bytes ) { return fd_base58_encoded_len( bytes, 4UL ); }
+unsigned long fd_base58_encoded_len_64( unsigned char const * bytes ) { return fd_base58_encoded_len( bytes, 8UL ); }
+
+unsigned long
+fd_base58_encoded_len_32_batch( unsigned char const * bytes,
+                                unsigned long         cnt,
+                                unsigned char *       opt_len ) {
+  unsigned long total = 0UL;
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    unsigned long len = fd_base58_encoded_len( bytes+32UL*i, 4UL );
+    total += len;
+    if( opt_len ) opt_len[ i ] = (unsigned char)len;
+  }
+  return total;
+}
+
+unsigned long
+fd_base58_encoded_len_64_batch( unsigned char const * bytes,
+                                unsigned long         cnt,
+                                unsigned char *       opt_len ) {
+  unsigned long total = 0UL;
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    unsigned long len = fd_base58_encoded_len( bytes+64UL*i, 8UL );
+    total += len;
+    if( opt_len ) opt_len[ i ] = (unsigned char)len;
+  }
+  return total;
+}
+
+char *
+fd_base58_encode_32_batch( unsigned char const * bytes,
+                           unsigned long         cnt,
+                           unsigned            * opt_len,
+                           char                * out ) {
+  fd_base58_backend_t const * b = fd_base58_backend_query( FD_BASE58_OP_ENCODE_32 );
+  if( FD_LIKELY( b->encode_32_batch ) ) return b->encode_32_batch( bytes, cnt, opt_len, out );
+  for( unsigned long i=0UL; i<cnt; i++ )
+    b->encode_32( bytes+32UL*i, opt_len ? opt_len+i : NULL, out+FD_BASE58_ENCODED_32_SZ*i );
+  return out;
+}
+
+char *
+fd_base58_encode_64_batch( unsigned char const * bytes,
+                           unsigned long         cnt,
+                           unsigned            * opt_len,
+                           char                * out ) {
+  fd_base58_backend_t const * b = fd_base58_backend_query( FD_BASE58_OP_ENCODE_64 );
+  if( FD_LIKELY( b->encode_64_batch ) ) return b->encode_64_batch( bytes, cnt, opt_len, out );
+  for( unsigned long i=0UL; i<cnt; i++ )
+    b->encode_64( bytes+64UL*i, opt_len ? opt_len+i : NULL, out+FD_BASE58_ENCODED_64_SZ*i );
+  return out;
+}
+
+unsigned long
+fd_base58_decode_32_batch( char const * const * encoded,
+                           unsigned long        cnt,
+                           unsigned char *      out,
+                           unsigned char *      opt_valid ) {
+  fd_base58_backend_t const * b = fd_base58_backend_query( FD_BASE58_OP_DECODE_32 );
+  if( FD_LIKELY( b->decode_32_batch ) ) return b->decode_32_batch( encoded, cnt, out, opt_valid );
+  unsigned long valid_cnt = 0UL;
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    int valid = !!b->decode_32( encoded[ i ], out+32UL*i );
+    valid_cnt += (unsigned long)valid;
+    if( opt_valid ) opt_valid[ i ] = (unsigned char)valid;
+  }
+  return valid_cnt;
+}
+
+unsigned long
+fd_base58_decode_64_batch( char const * const * encoded,
+                           unsigned long        cnt,
+                           unsigned char *      out,
+                           unsigned char *      opt_valid ) {
+  fd_base58_backend_t const * b = fd_base58_backend_query( FD_BASE58_OP_DECODE_64 );
+  if( FD_LIKELY( b->decode_64_batch ) ) return b->decode_64_batch( encoded, cnt, out, opt_valid );
+  unsigned long valid_cnt = 0UL;
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    int valid = !!b->decode_64( encoded[ i ], out+64UL*i );
+    valid_cnt += (unsigned long)valid;
+    if( opt_valid ) opt_valid[ i ] = (unsigned char)valid;
+  }
+  return valid_cnt;
+}
+
+/* The packed conversions run the batch conversions on chunks of
+   FD_BASE58_PACKED_CHUNK inputs, staged on the stack: the batch kernels
+   work on nul terminated cstrs in FD_BASE58_ENCODED_{32,64}_SZ wide
+   slots, and the packed layout has neither. */
+
+#define FD_BASE58_PACKED_CHUNK (64UL)
+
+/* FD_BASE58_PACKED_PAD is the room left after the last staged cstr for
+   the decode kernels to read past its nul terminator: up to the widest
+   vector load from its start (two 64 byte vectors, for the AVX-512
+   batch kernel at N==64). */
+
+#define FD_BASE58_PACKED_PAD (128UL)
+
+/* fd_base58_packed_reject is what the kernels get in place of a slot
+   that can't be staged as a cstr.  It is the empty string, which never
+   decodes to 32 or 64 bytes, and it is FD_BASE58_PACKED_PAD long, so the
+   vector loads past its nul stay inside it, as they do for the staged
+   cstrs. */
+
+static char const fd_base58_packed_reject[ FD_BASE58_PACKED_PAD ];
+
+static char *
+fd_base58_encode_packed( unsigned char const * bytes,
+                         unsigned long         cnt,
+                         unsigned char *       opt_len,
+                         char *                out,
+                         unsigned long         byte_cnt,
+                         unsigned long         max_len,
+                         char * (*batch)( unsigned char const *, unsigned long, unsigned *, char * ) ) {
+  char     buf[ FD_BASE58_PACKED_CHUNK*FD_BASE58_ENCODED_64_SZ ];
+  unsigned len[ FD_BASE58_PACKED_CHUNK ];
+  for( unsigned long i=0UL; i<cnt; i+=FD_BASE58_PACKED_CHUNK ) {
+    unsigned long chunk_cnt = cnt-i<FD_BASE58_PACKED_CHUNK ? cnt-i : FD_BASE58_PACKED_CHUNK;
+    batch( bytes+byte_cnt*i, chunk_cnt, len, buf );
+    for( unsigned long j=0UL; j<chunk_cnt; j++ ) {
+      char * slot = out+max_len*(i+j);
+      memcpy( slot, buf+(max_len+1UL)*j, len[ j ] );
+      memset( slot+len[ j ], 0, max_len-len[ j ] );
+      if( opt_len ) opt_len[ i+j ] = (unsigned char)len[ j ];
+    }
+  }
+  return out;
+}
+
+static unsigned long
+fd_base58_decode_packed( char const *          slots,
+                         unsigned char const * opt_len,
+                         unsigned long         cnt,
+                         unsigned char *       out,
+                         signed char *         opt_err,
+                         unsigned long         byte_cnt,
+                         unsigned long         max_len,
+                         unsigned long (*batch)( char const * const *, unsigned long, unsigned char *, unsigned char * ),
+                         int (*ex)( char const *, unsigned long, unsigned char *, unsigned long * ) ) {
+  char          buf[ FD_BASE58_PACKED_CHUNK*FD_BASE58_ENCODED_64_SZ+FD_BASE58_PACKED_PAD ];
+  char const *  ptr[ FD_BASE58_PACKED_CHUNK ];
+  unsigned long len[ FD_BASE58_PACKED_CHUNK ];
+  unsigned char valid[ FD_BASE58_PACKED_CHUNK ];
+  unsigned long valid_cnt = 0UL;
+  for( unsigned long i=0UL; i<cnt; i+=FD_BASE58_PACKED_CHUNK ) {
+    unsigned long chunk_cnt = cnt-i<FD_BASE58_PACKED_CHUNK ? cnt-i : FD_BASE58_PACKED_CHUNK;
+    for( unsigned long j=0UL; j<chunk_cnt; j++ ) {
+      char const * slot = slots+max_len*(i+j);
+      len[ j ] = opt_len ? (unsigned long)opt_len[ i+j ] : strnlen( slot, max_len );
+      /* Too long or with an embedded '\0', which the cstr would hide:
+         give the kernels something they reject, ex says why below. */
+      ptr[ j ] = fd_base58_packed_reject;
+      if( FD_LIKELY( len[ j ]<=max_len ) ) {
+        char * cstr = buf+(max_len+1UL)*j;
+        memcpy( cstr, slot, len[ j ] );
+        cstr[ len[ j ] ] = '\0';
+        if( FD_LIKELY( strlen( cstr )==len[ j ] ) ) ptr[ j ] = cstr;
+      }
+    }
+    valid_cnt += batch( ptr, chunk_cnt, out+byte_cnt*i, valid );
+    for( unsigned long j=0UL; j<chunk_cnt; j++ ) {
+      int err = FD_BASE58_SUCCESS;
+      if( FD_UNLIKELY( !valid[ j ] ) ) {
+        unsigned char * row = out+byte_cnt*(i+j);
+        err = ex( slots+max_len*(i+j), len[ j ], row, NULL );
+        memset( row, 0, byte_cnt );
+      }
+      if( opt_err ) opt_err[ i+j ] = (signed char)err;
+    }
+  }
+  return valid_cnt;
+}
+
+char *
+fd_base58_encode_32_packed( unsigned char const * bytes,
+                            unsigned long         cnt,
+                            unsigned char *       opt_len,
+                            char *                out ) {
+  return fd_base58_encode_packed( bytes, cnt, opt_len, out, 32UL, FD_BASE58_ENCODED_32_LEN, fd_base58_encode_32_batch );
+}
+
+char *
+fd_base58_encode_64_packed( unsigned char const * bytes,
+                            unsigned long         cnt,
+                            unsigned char *       opt_len,
+                            char *                out ) {
+  return fd_base58_encode_packed( bytes, cnt, opt_len, out, 64UL, FD_BASE58_ENCODED_64_LEN, fd_base58_encode_64_batch );
+}
+
+unsigned long
+fd_base58_decode_32_packed( char const *          slots,
+                            unsigned char const * opt_len,
+                            unsigned long         cnt,
+                            unsigned char *       out,
+                            signed char *         opt_err ) {
+  return fd_base58_decode_packed( slots, opt_len, cnt, out, opt_err, 32UL, FD_BASE58_ENCODED_32_LEN,
+                                  fd_base58_decode_32_batch, fd_base58_decode_32_ex );
+}
+
+unsigned long
+fd_base58_decode_64_packed( char const *          slots,
+                            unsigned char const * opt_len,
+                            unsigned long         cnt,
+                            unsigned char *       out,
+                            signed char *         opt_err ) {
+  return fd_base58_decode_packed( slots, opt_len, cnt, out, opt_err, 64UL, FD_BASE58_ENCODED_64_LEN,
+                                  fd_base58_decode_64_batch, fd_base58_decode_64_ex );
+}
+
+#undef FD_BASE58_PACKED_PAD
+#undef FD_BASE58_PACKED_CHUNK
@@ -37,6 +37,42 @@
 char * fd_base58_encode_32( unsigned char const * bytes, unsigned * opt_len, char * out );
 char * fd_base58_encode_64( unsigned char const * bytes, unsigned * opt_len, char * out );
 
+/* fd_base58_encoded_len_{32,64}: Returns the length (not counting nul)
+   of the cstr fd_base58_encode_{32,64} would produce for bytes, without
+   encoding them.  This is a table lookup and at most one comparison
+   against a power of 58 (a few ns).
+
+   fd_base58_encode_{32,64} only write the first encoded_len+1 bytes of
+   out, so when the length is computed up front, out needs only that
+   much space instead of FD_BASE58_ENCODED_{32,64}_SZ. */
+
+unsigned long fd_base58_encoded_len_32( unsigned char const * bytes );
+unsigned long fd_base58_encoded_len_64( unsigned char const * bytes );
+
+/* fd_base58_encoded_len_{32,64}_batch: Returns the total length of the
+   encodings of the cnt inputs of 32 or 64 bytes each stored
+   contiguously at bytes (i.e. the room needed to store them back to back
+   without nul terminators).  If opt_len is non-NULL, opt_len[i] is set to
+   the length of the i-th (at most 88, so it fits in a byte). */
+
+unsigned long fd_base58_encoded_len_32_batch( unsigned char const * bytes, unsigned long cnt, unsigned char * opt_len );
+unsigned long fd_base58_encoded_len_64_batch( unsigned char const * bytes, unsigned long cnt, unsigned char * opt_len );
+
+/* fd_base58_encode_{32,64}_batch: Converts cnt inputs of 32 or 64 bytes
+   each, stored contiguously at bytes, as fd_base58_encode_{32,64}
+   would.  The i-th output is stored at out+i*FD_BASE58_ENCODED_{32,64}_SZ
+   (nul terminated) and, if opt_len is non-NULL, opt_len[i] is set to
+   its length.  Returns out.
+
+   This is for bulk conversions, where throughput matters more than
+   latency: on the avx512 backend, it converts 8 inputs at once in the
+   lanes of each vector.  On the others, it converts them one at a time
+   with the backend's own kernel.  It runs on the backend
+   FD_BASE58_OP_ENCODE_{32,64} is bound to. */
+
+char * fd_base58_encode_32_batch( unsigned char const * bytes, unsigned long cnt, unsigned * opt_len, char * out );
+char * fd_base58_encode_64_batch( unsigned char const * bytes, unsigned long cnt, unsigned * opt_len, char * out );
+
 /* fd_base58_decode_{32, 64}: Converts the base58 encoded number stored
    in the cstr `encoded` to a 32 or 64 byte number, which is written to
    out in big endian.  out must have room for 32 and 64 bytes respective
@@ -46,11 +82,127 @@ char * fd_base58_encode_64( unsigned char const * bytes, unsigned * opt_len, cha
    undefined on failure (i.e. out may be clobbered).
 
    A similar note to the above applies: these are high performance
-   (~120ns for 32 byte and ~300ns for 64 byte), but base58 is an
-   inherently slow format and should not be used in any performance
-   critical places except where absolutely necessary. */
+   (~120ns for 32 byte and ~300ns for 64 byte without AVX, and roughly
+   twice as fast with AVX), but base58 is an inherently slow format and
+   should not be used in any performance critical places except where
+   absolutely necessary.
+
+   Like strlen, the vector front ends (the AVX2, IFMA and SSE2 ones, and
+   the AVX-512 batch kernels below) may read encoded past its nul
+   terminator: up to 128 bytes from its start, but never into the next
+   page, so this can't fault on ordinary memory.  It can still trip
+   memory checkers and guards finer than a page, and reads whatever
+   follows the string in the same page.  Use fd_base58_decode_{32,64}_len,
+   which never reads past encoded+len, for inputs in guarded or mmap'd
+   buffers. */
 
 unsigned char * fd_base58_decode_32( char const * encoded, unsigned char * out );
 unsigned char * fd_base58_decode_64( char const * encoded, unsigned char * out );
 
+/* fd_base58_decode_{32,64}_len: Same as fd_base58_decode_{32,64}, but
+   the input is the len characters at encoded, which need not be nul
+   terminated (e.g. a slice of a larger buffer).  Doesn't read past
+   encoded+len.  A '\0' among those characters makes the input
+   invalid. */
+
+unsigned char * fd_base58_decode_32_len( char const * encoded, unsigned long len, unsigned char * out );
+unsigned char * fd_base58_decode_64_len( char const * encoded, unsigned long len, unsigned char * out );
+
+/* FD_BASE58_{SUCCESS,ERR_*}: Results of fd_base58_decode_{32,64}_ex,
+   i.e. why an input doesn't decode. */
+
+#define FD_BASE58_SUCCESS           (0)
+#define FD_BASE58_ERR_LEN          (-1) /* Longer than FD_BASE58_ENCODED_{32,64}_LEN */
+#define FD_BASE58_ERR_CHAR         (-2) /* Not a base58 character (including '\0') */
+#define FD_BASE58_ERR_OVERFLOW     (-3) /* The number doesn't fit in 32 or 64 bytes */
+#define FD_BASE58_ERR_LEADING_ONES (-4) /* Leading '1's != leading zero bytes (e.g. too short) */
+
+/* fd_base58_decode_{32,64}_ex: Same as fd_base58_decode_{32,64}_len,
+   but returns FD_BASE58_SUCCESS or the FD_BASE58_ERR_* saying why the
+   input is invalid.  If opt_err_off is non-NULL, on failure it is set
+   to the offset of the offending character: the first invalid one for
+   FD_BASE58_ERR_CHAR, the first one past the maximum length for
+   FD_BASE58_ERR_LEN, and 0 otherwise, when no single character is at
+   fault.  Valid inputs cost the same as with the _len variant; working
+   out the error takes a slower second pass over invalid ones.
+
+   fd_base58_strerror: Returns a short description of an FD_BASE58_*
+   result, or "unknown error". */
+
+int fd_base58_decode_32_ex( char const * encoded, unsigned long len, unsigned char * out, unsigned long * opt_err_off );
+int fd_base58_decode_64_ex( char const * encoded, unsigned long len, unsigned char * out, unsigned long * opt_err_off );
+
+char const * fd_base58_strerror( int err );
+
+/* fd_base58_decode_{32,64}_batch: Converts the cnt base58 cstrs
+   encoded[0..cnt) as fd_base58_decode_{32,64} would, storing the i-th
+   result at out+i*{32,64}.  The strings can have different lengths.
+   Returns the number of valid inputs.  If opt_valid is non-NULL,
+   opt_valid[i] is set to 1 if the i-th input is valid and 0 if not (in
+   which case its output is clobbered).
+
+   Like fd_base58_encode_{32,64}_batch, this converts 8 inputs at once
+   on the avx512 backend, and one at a time on the others.  Each cstr may
+   be read past its nul, as with fd_base58_decode_{32,64}. */
+
+unsigned long fd_base58_decode_32_batch( char const * const * encoded, unsigned long cnt, unsigned char * out, unsigned char * opt_valid );
+unsigned long fd_base58_decode_64_batch( char const * const * encoded, unsigned long cnt, unsigned char * out, unsigned char * opt_valid );
+
+/* fd_base58_encode_{32,64}_packed: Same as fd_base58_encode_{32,64}_batch,
+   but the i-th output is stored at out+i*FD_BASE58_ENCODED_{32,64}_LEN,
+   padded with '\0's to that width (so an output of the maximum length
+   has no nul).  out needs room for cnt*FD_BASE58_ENCODED_{32,64}_LEN
+   characters.  If opt_len is non-NULL, opt_len[i] is set to the length
+   of the i-th output.  Returns out.
+
+   fd_base58_decode_{32,64}_packed: The reverse.  Decodes the cnt slots
+   of FD_BASE58_ENCODED_{32,64}_LEN characters at slots, storing the
+   i-th result at out+i*{32,64}.  The i-th input is the first opt_len[i]
+   characters of its slot or, if opt_len is NULL, the characters before
+   the first '\0' in it.  Returns the number of valid inputs.  The
+   result of an invalid input is zeroed, and if opt_err is non-NULL,
+   opt_err[i] is set to FD_BASE58_SUCCESS or the FD_BASE58_ERR_* saying
+   why the i-th input is invalid (see fd_base58_decode_{32,64}_ex).
+
+   Both go through the batch conversions a chunk at a time, so they use
+   the AVX-512 batch kernels when bound to the avx512 backend. */
+
+char * fd_base58_encode_32_packed( unsigned char const * bytes, unsigned long cnt, unsigned char * opt_len, char * out );
+char * fd_base58_encode_64_packed( unsigned char const * bytes, unsigned long cnt, unsigned char * opt_len, char * out );
+
+unsigned long fd_base58_decode_32_packed( char const * slots, unsigned char const * opt_len, unsigned long cnt, unsigned char * out, signed char * opt_err );
+unsigned long fd_base58_decode_64_packed( char const * slots, unsigned char const * opt_len, unsigned long cnt, unsigned char * out, signed char * opt_err );
+
+/* FD_BASE58_OP_*: The conversions above, which can be bound to a
+   backend independently (the batch and packed conversions follow the
+   binding of the single conversion of the same size and direction). */
+
+#define FD_BASE58_OP_ENCODE_32 (0)
+#define FD_BASE58_OP_ENCODE_64 (1)
+#define FD_BASE58_OP_DECODE_32 (2)
+#define FD_BASE58_OP_DECODE_64 (3)
+#define FD_BASE58_OP_CNT       (4)
+
+/* fd_base58_backend_name: Returns the name of the idx-th backend that
+   is compiled in and supported by the CPU running this code, in order
+   of preference (e.g. "avx512", "avx2", "scalar"), or NULL if idx is past
+   the last one.
+
+   fd_base58_backend: Returns the name of the backend op is bound to.
+   If op is negative, returns the name of the backend all ops are bound
+   to, or "mixed" if they differ.  Returns NULL for an invalid op.  On
+   first use, each op is bound to the most preferred backend.
+
+   fd_base58_set_backend: Binds op to the backend called name, which is
+   one of the names returned by fd_base58_backend_name or "auto" for the
+   default.  If op is negative, binds all ops.  Returns 0 on success and
+   -1 if name isn't a supported backend or op is invalid (in which case
+   nothing changes).  This is safe to call while other threads convert;
+   each conversion runs entirely on either the old or the new
+   backend. */
+
+char const * fd_base58_backend_name( unsigned long idx );
+char const * fd_base58_backend     ( int op );
+int          fd_base58_set_backend ( char const * name, int op );
+
 #endif /* HEADER_fd_base58_h */
@@ -0,0 +1,97 @@
+#ifndef HEADER_fd_base58_adx_h
+#define HEADER_fd_base58_adx_h
+
+/* BMI2/ADX helpers used by fd_base58_wide_tmpl.h when FD_HAS_ADX is
+   set.  Only include this from a region compiled with
+   FD_BASE58_TARGET_PUSH( FD_BASE58_ADX ).
+
+   mulx multiplies without touching the flags, and adcx/adox add with
+   carry through CF and OF respectively, so two independent carry
+   chains can be interleaved with the multiplies. */
+
+/* fd_base58_adx_mac adds m*T to the big endian multiprecision number
+   a[0..cnt] (cnt+1 words), where T is the big endian number t[0..cnt)
+   aligned with a[1..cnt].  The low halves of the products go into the
+   CF chain (adcx) and the high halves into the OF chain (adox), and
+   mulx leaves both alone, so the two chains run interleaved.  Returns
+   the carry out of a[0] (0, 1 or 2), which the caller propagates.
+
+   This is inline asm because compilers lower _addcarryx_u64 to plain
+   adc, which serializes both chains on CF.  cnt is at most 8, and a
+   constant once inlined, so the switch folds to one block. */
+
+/* FD_BASE58_ADX_STEP(k,k1,cur,nxt) does word k: cur holds a[k] with
+   the previous high half already added, gets the low half of
+   m*t[k-1] (k1 is the byte offset of word k-1) and is stored, then
+   a[k-1] is loaded into nxt and gets the high half.  Words alternate
+   between the r0 and r1 registers, so each step only names its own. */
+
+#define FD_BASE58_ADX_STEP( k, k1, cur, nxt )  \
+  "mulxq " k1 "(%[t]), %[lo], %[hi]\n\t"       \
+  "adcxq %[lo], %[" cur "]\n\t"                \
+  "movq  %[" cur "], " k "(%[a])\n\t"          \
+  "movq  " k1 "(%[a]), %[" nxt "]\n\t"         \
+  "adoxq %[hi], %[" nxt "]\n\t"
+
+#define FD_BASE58_ADX_STEPS_1                                   FD_BASE58_ADX_STEP( "8",  "0",  "r1", "r0" )
+#define FD_BASE58_ADX_STEPS_2 FD_BASE58_ADX_STEP( "16", "8",  "r0", "r1" ) FD_BASE58_ADX_STEPS_1
+#define FD_BASE58_ADX_STEPS_3 FD_BASE58_ADX_STEP( "24", "16", "r1", "r0" ) FD_BASE58_ADX_STEPS_2
+#define FD_BASE58_ADX_STEPS_4 FD_BASE58_ADX_STEP( "32", "24", "r0", "r1" ) FD_BASE58_ADX_STEPS_3
+#define FD_BASE58_ADX_STEPS_5 FD_BASE58_ADX_STEP( "40", "32", "r1", "r0" ) FD_BASE58_ADX_STEPS_4
+#define FD_BASE58_ADX_STEPS_6 FD_BASE58_ADX_STEP( "48", "40", "r0", "r1" ) FD_BASE58_ADX_STEPS_5
+#define FD_BASE58_ADX_STEPS_7 FD_BASE58_ADX_STEP( "56", "48", "r1", "r0" ) FD_BASE58_ADX_STEPS_6
+#define FD_BASE58_ADX_STEPS_8 FD_BASE58_ADX_STEP( "64", "56", "r0", "r1" ) FD_BASE58_ADX_STEPS_7
+
+/* xor clears CF and OF to start both chains.  a[0] ends up in r0. */
+
+#define FD_BASE58_ADX_CASE( cnt, k, cur )                       \
+  case cnt:                                                     \
+    __asm__( "xorl  %k[lo], %k[lo]\n\t"                         \
+             "movq  " k "(%[a]), %[" cur "]\n\t"                \
+             FD_BASE58_ADX_STEPS_##cnt                          \
+             "movq  %[r0], (%[a])\n\t"                          \
+             : [r0] "=&r" (r0), [r1] "=&r" (r1),                \
+               [lo] "=&r" (lo), [hi] "=&r" (hi),                \
+               "=@ccc" (c_lo), "=@cco" (c_hi)                   \
+             : [a] "r" (a), [t] "r" (t), "d" (m)                \
+             : "memory" );                                      \
+    break
+
+static inline __attribute__((always_inline)) uint64_t
+fd_base58_adx_mac( uint64_t *       a,
+                   uint64_t const * t,
+                   uint64_t         m,
+                   uint64_t         cnt ) {
+  uint64_t r0, r1, lo, hi;
+  unsigned char c_lo, c_hi;
+  switch( cnt ) {
+    FD_BASE58_ADX_CASE( 1, "8",  "r1" );
+    FD_BASE58_ADX_CASE( 2, "16", "r0" );
+    FD_BASE58_ADX_CASE( 3, "24", "r1" );
+    FD_BASE58_ADX_CASE( 4, "32", "r0" );
+    FD_BASE58_ADX_CASE( 5, "40", "r1" );
+    FD_BASE58_ADX_CASE( 6, "48", "r0" );
+    FD_BASE58_ADX_CASE( 7, "56", "r1" );
+    default:
+    FD_BASE58_ADX_CASE( 8, "64", "r0" );
+  }
+  (void)r1; (void)lo; (void)hi;
+
+  /* The CF chain's last carry goes into a[0], after the OF chain's. */
+
+  a[ 0 ] += c_lo;
+  return (uint64_t)( a[ 0 ]<c_lo ) + (uint64_t)c_hi;
+}
+
+#undef FD_BASE58_ADX_CASE
+#undef FD_BASE58_ADX_STEPS_8
+#undef FD_BASE58_ADX_STEPS_7
+#undef FD_BASE58_ADX_STEPS_6
+#undef FD_BASE58_ADX_STEPS_5
+#undef FD_BASE58_ADX_STEPS_4
+#undef FD_BASE58_ADX_STEPS_3
+#undef FD_BASE58_ADX_STEPS_2
+#undef FD_BASE58_ADX_STEPS_1
+#undef FD_BASE58_ADX_STEP
+
+#endif /* HEADER_fd_base58_adx_h */
@@ -0,0 +1,174 @@
+#ifndef HEADER_fd_base58_avx_h
+#define HEADER_fd_base58_avx_h
+
+/* AVX2 helpers used by fd_base58_tmpl.h when FD_HAS_AVX is set.  Only
+   include this from a region compiled with FD_BASE58_TARGET_PUSH(
+   "avx2" ) (or wider). */
+
+#include <immintrin.h>
+
+/* fd_base58_avx_div3364 returns floor(v/3364) for each of the 8 u32
+   lanes of v.  Requires every lane of v < 2^30.
+
+   3364 = 58^2.  This uses the multiplier ceil(2^43/3364), whose error is
+   below 2^-13 for v < 2^30, less than the distance from any v/3364 to
+   the next integer (at least 1/3364). */
+
+static inline __m256i
+fd_base58_avx_div3364( __m256i v ) {
+  __m256i const magic = _mm256_set1_epi64x( 2614772005L );
+  __m256i even = _mm256_srli_epi64( _mm256_mul_epu32( v,                          magic ), 43 );
+  __m256i odd  = _mm256_srli_epi64( _mm256_mul_epu32( _mm256_srli_epi64( v, 32 ), magic ), 11 );
+  return _mm256_blend_epi32( even, odd, 0xAA );
+}
+
+/* fd_base58_avx_intermediate_to_raw converts 8 u32 lanes, each holding
+   a value less than 58^5, to 40 base58 digits (5 per lane, most
+   significant first) and stores them to raw.  Lane i's digits go to
+   raw[5i..5i+4].  Writes up to 46 bytes at raw (the extra 6 bytes are
+   garbage that the caller must either ignore or overwrite).
+
+   The digits are extracted in two steps: a u32 split by 58^2 and then
+   u16 splits by 58.  For x < 3364, (x*1130)>>16 == x/58. */
+
+static inline void
+fd_base58_avx_intermediate_to_raw( __m256i v,
+                                   uint8_t * raw ) {
+  __m256i c3364 = _mm256_set1_epi32( 3364 );
+
+  __m256i q  = fd_base58_avx_div3364( v );                       /* < 58^3 */
+  __m256i r  = _mm256_sub_epi32( v, _mm256_mullo_epi32( q,  c3364 ) ); /* < 58^2 */
+  __m256i d0 = fd_base58_avx_div3364( q );                       /* < 58   */
+  __m256i t  = _mm256_sub_epi32( q, _mm256_mullo_epi32( d0, c3364 ) ); /* < 58^2 */
+
+  /* In each u32 lane, x = t | r<<16.  Then y = d1 | d3<<16 and
+     z = d2 | d4<<16. */
+
+  __m256i x = _mm256_or_si256( t, _mm256_slli_epi32( r, 16 ) );
+  __m256i y = _mm256_mulhi_epu16( x, _mm256_set1_epi16( 1130 ) );
+  __m256i z = _mm256_sub_epi16( x, _mm256_mullo_epi16( y, _mm256_set1_epi16( 58 ) ) );
+
+  /* a holds digits 0-3 of each lane as bytes, b holds digit 4.  Pair
+     them up in u64 lanes, which then hold a lane's 5 digits in memory
+     order. */
+
+  __m256i a  = _mm256_or_si256( _mm256_or_si256( d0, _mm256_slli_epi16( y, 8 ) ), _mm256_slli_epi32( z, 16 ) );
+  __m256i b  = _mm256_srli_epi32( z, 16 );
+  __m256i lo = _mm256_unpacklo_epi32( a, b ); /* lanes 0,1 | 4,5 */
+  __m256i hi = _mm256_unpackhi_epi32( a, b ); /* lanes 2,3 | 6,7 */
+
+  __m256i compact = _mm256_setr_epi8( 0, 1, 2, 3, 4, 8, 9, 10, 11, 12, -1, -1, -1, -1, -1, -1,
+                                      0, 1, 2, 3, 4, 8, 9, 10, 11, 12, -1, -1, -1, -1, -1, -1 );
+  lo = _mm256_shuffle_epi8( lo, compact );
+  hi = _mm256_shuffle_epi8( hi, compact );
+
+  _mm_storeu_si128( (__m128i *)(raw+ 0), _mm256_castsi256_si128   ( lo    ) );
+  _mm_storeu_si128( (__m128i *)(raw+10), _mm256_castsi256_si128   ( hi    ) );
+  _mm_storeu_si128( (__m128i *)(raw+20), _mm256_extracti128_si256 ( lo, 1 ) );
+  _mm_storeu_si128( (__m128i *)(raw+30), _mm256_extracti128_si256 ( hi, 1 ) );
+}
+
+/* fd_base58_avx_raw_to_chars maps 32 base58 digits in [0,58) to their
+   characters in base58_chars. */
+
+static inline __m256i
+fd_base58_avx_raw_to_chars( __m256i d ) {
+  /* The alphabet is '1' + d, plus a gap for each skipped character
+     range: 7 after '9', then 1 each to skip 'I' and 'O', 6 after 'Z'
+     and 1 to skip 'l'.  cmpgt gives -1 where a gap applies. */
+  __m256i c = _mm256_add_epi8( d, _mm256_set1_epi8( '1' ) );
+  c = _mm256_add_epi8( c, _mm256_and_si256( _mm256_cmpgt_epi8( d, _mm256_set1_epi8(  8 ) ), _mm256_set1_epi8( 7 ) ) );
+  c = _mm256_sub_epi8( c,                   _mm256_cmpgt_epi8( d, _mm256_set1_epi8( 16 ) )                            );
+  c = _mm256_sub_epi8( c,                   _mm256_cmpgt_epi8( d, _mm256_set1_epi8( 21 ) )                            );
+  c = _mm256_add_epi8( c, _mm256_and_si256( _mm256_cmpgt_epi8( d, _mm256_set1_epi8( 32 ) ), _mm256_set1_epi8( 6 ) ) );
+  c = _mm256_sub_epi8( c,                   _mm256_cmpgt_epi8( d, _mm256_set1_epi8( 43 ) )                            );
+  return c;
+}
+
+/* fd_base58_avx_invalid_mask returns a 32-bit mask with bit i set if
+   byte i of v is not a base58 character.
+
+   Classifies by nibble: hi_tbl maps the high nibble to a class bit
+   (0x10 for high nibbles that never hold a base58 character) and
+   lo_tbl maps the low nibble to the set of classes for which it is
+   invalid.  A byte is valid iff the two don't intersect.  Bytes >=0x80
+   have a high nibble >=8, which maps to 0x10. */
+
+static inline uint32_t
+fd_base58_avx_invalid_mask( __m256i v ) {
+  __m256i const hi_tbl = _mm256_setr_epi8( 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                           0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+  __m256i const lo_tbl = _mm256_setr_epi8( 0x1B, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                           0x10, 0x12, 0x11, 0x15, 0x1D, 0x15, 0x15, 0x17,
+                                           0x1B, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                           0x10, 0x12, 0x11, 0x15, 0x1D, 0x15, 0x15, 0x17 );
+  __m256i nib = _mm256_set1_epi8( 0x0F );
+  __m256i hi  = _mm256_shuffle_epi8( hi_tbl, _mm256_and_si256( _mm256_srli_epi16( v, 4 ), nib ) );
+  __m256i lo  = _mm256_shuffle_epi8( lo_tbl, _mm256_and_si256( v, nib ) );
+  __m256i ok  = _mm256_cmpeq_epi8( _mm256_and_si256( hi, lo ), _mm256_setzero_si256() );
+  return ~(uint32_t)_mm256_movemask_epi8( ok );
+}
+
+/* fd_base58_avx_chars_to_raw is the inverse of
+   fd_base58_avx_raw_to_chars.  Bytes that aren't base58 characters map
+   to garbage. */
+
+static inline __m256i
+fd_base58_avx_chars_to_raw( __m256i c ) {
+  __m256i d = _mm256_sub_epi8( c, _mm256_set1_epi8( '1' ) );
+  d = _mm256_sub_epi8( d, _mm256_and_si256( _mm256_cmpgt_epi8( c, _mm256_set1_epi8( '9' ) ), _mm256_set1_epi8( 7 ) ) );
+  d = _mm256_add_epi8( d,                   _mm256_cmpgt_epi8( c, _mm256_set1_epi8( 'H' ) )                            );
+  d = _mm256_add_epi8( d,                   _mm256_cmpgt_epi8( c, _mm256_set1_epi8( 'N' ) )                            );
+  d = _mm256_sub_epi8( d, _mm256_and_si256( _mm256_cmpgt_epi8( c, _mm256_set1_epi8( 'Z' ) ), _mm256_set1_epi8( 6 ) ) );
+  d = _mm256_add_epi8( d,                   _mm256_cmpgt_epi8( c, _mm256_set1_epi8( 'k' ) )                            );
+  return d;
+}
+
+/* fd_base58_avx_raw_to_intermediate is the inverse of
+   fd_base58_avx_intermediate_to_raw: it returns 8 u32 lanes where lane
+   i is the value of the base58 digits raw[5i..5i+4] (most significant
+   first).  Reads up to 43 bytes at raw. */
+
+static inline __m256i
+fd_base58_avx_raw_to_intermediate( uint8_t const * raw ) {
+  __m256i idx = _mm256_setr_epi32( 0, 5, 10, 15, 20, 25, 30, 35 );
+
+  /* a holds digits 0-3 of each lane as bytes, and the low byte of b is
+     digit 4. */
+  __m256i a = _mm256_i32gather_epi32( (int const *)raw,     idx, 1 );
+  __m256i b = _mm256_i32gather_epi32( (int const *)(raw+4), idx, 1 );
+
+  __m256i p = _mm256_maddubs_epi16( a, _mm256_set1_epi16( 58 | (1<<8) ) ); /* d0*58+d1, d2*58+d3 */
+  __m256i q = _mm256_madd_epi16   ( p, _mm256_set1_epi32( 3364 | (1<<16) ) ); /* d0..d3 */
+  return _mm256_add_epi32( _mm256_mullo_epi32( q, _mm256_set1_epi32( 58 ) ),
+                           _mm256_and_si256( b, _mm256_set1_epi32( 0xFF ) ) );
+}
+
+/* fd_base58_avx_zero_mask returns a 32-bit mask with bit i set if byte
+   i of v is zero. */
+
+static inline uint32_t
+fd_base58_avx_zero_mask( __m256i v ) {
+  return (uint32_t)_mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) );
+}
+
+/* fd_base58_avx_eq_mask returns a 32-bit mask with bit i set if byte i
+   of v is c. */
+
+static inline uint32_t
+fd_base58_avx_eq_mask( __m256i v,
+                       char    c ) {
+  return (uint32_t)_mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( c ) ) );
+}
+
+/* fd_base58_avx_bswap32 reverses the bytes within each u32 lane. */
+
+static inline __m256i
+fd_base58_avx_bswap32( __m256i v ) {
+  return _mm256_shuffle_epi8( v, _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                   3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 ) );
+}
+
+#endif /* HEADER_fd_base58_avx_h */
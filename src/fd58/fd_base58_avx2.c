@@ -0,0 +1,28 @@
+/* AVX2 kernels.  These are the kernels from fd_base58_tmpl.h built with
+   FD_HAS_AVX.  The dispatch in fd_base58.c only calls them on CPUs that
+   support AVX2. */
+
+#include "fd_base58_private.h"
+
+#if FD_HAS_X86
+
+FD_BASE58_TARGET_PUSH( "avx2" )
+
+#include "fd_base58_avx.h"
+
+#define FD_HAS_AVX 1
+#define KERNEL     avx2
+
+#define N                32
+#define INTERMEDIATE_SZ (9UL)
+#define BINARY_SZ       ((uint64_t)N/4UL)
+#include "fd_base58_tmpl.h"
+
+#define N                64
+#define INTERMEDIATE_SZ (18UL)
+#define BINARY_SZ       ((uint64_t)N/4UL)
+#include "fd_base58_tmpl.h"
+
+FD_BASE58_TARGET_POP()
+
+#endif /* FD_HAS_X86 */
@@ -0,0 +1,25 @@
+/* AVX-512 batch kernels, see fd_base58_avx512_tmpl.h.  The dispatch in
+   fd_base58.c only calls them on CPUs that support the extensions in
+   FD_BASE58_AVX512. */
+
+#include "fd_base58_private.h"
+
+#if FD_HAS_X86
+
+FD_BASE58_TARGET_PUSH( FD_BASE58_AVX512 )
+
+#include "fd_base58_avx512.h"
+
+#define N                32
+#define INTERMEDIATE_SZ (9UL)
+#define BINARY_SZ       ((uint64_t)N/4UL)
+#include "fd_base58_avx512_tmpl.h"
+
+#define N                64
+#define INTERMEDIATE_SZ (18UL)
+#define BINARY_SZ       ((uint64_t)N/4UL)
+#include "fd_base58_avx512_tmpl.h"
+
+FD_BASE58_TARGET_POP()
+
+#endif /* FD_HAS_X86 */
@@ -0,0 +1,147 @@
+#ifndef HEADER_fd_base58_avx512_h
+#define HEADER_fd_base58_avx512_h
+
+/* AVX-512 helpers used by fd_base58_avx512_tmpl.h.  These work on 8
+   independent values at once, one per u64 lane.  Only include this
+   from a region compiled with FD_BASE58_TARGET_PUSH( FD_BASE58_AVX512 ). */
+
+#include <immintrin.h>
+
+/* fd_base58_avx512_divmod returns x mod 58^5 and stores floor(x/58^5)
+   in *q for each of the 8 u64 lanes of x.
+
+   The quotient is first estimated in double precision.  Its relative
+   error is a few ulp, so for x<2^64 (quotient<2^35) the estimate is off
+   by at most 1 either way, which the remainder check then fixes. */
+
+static inline __m512i
+fd_base58_avx512_divmod( __m512i   x,
+                         __m512i * q ) {
+  __m512i const d = _mm512_set1_epi64( 656356768L ); /* 58^5 */
+  __m512i const one = _mm512_set1_epi64( 1L );
+
+  __m512d qf = _mm512_mul_pd( _mm512_cvtepu64_pd( x ), _mm512_set1_pd( 1.0/656356768.0 ) );
+  __m512i qi = _mm512_cvttpd_epu64( qf );
+  __m512i r  = _mm512_sub_epi64( x, _mm512_mullo_epi64( qi, d ) );
+
+  __mmask8 under = _mm512_cmplt_epi64_mask( r, _mm512_setzero_si512() );
+  qi = _mm512_mask_sub_epi64( qi, under, qi, one );
+  r  = _mm512_mask_add_epi64( r,  under, r,  d   );
+
+  __mmask8 over = _mm512_cmpge_epi64_mask( r, d );
+  qi = _mm512_mask_add_epi64( qi, over, qi, one );
+  r  = _mm512_mask_sub_epi64( r,  over, r,  d   );
+
+  *q = qi;
+  return r;
+}
+
+/* fd_base58_avx512_intermediate_to_raw splits each u64 lane of v,
+   which must be less than 58^5, into its 5 base58 digits, most
+   significant first.  Uses the same steps as
+   fd_base58_avx_intermediate_to_raw. */
+
+static inline void
+fd_base58_avx512_intermediate_to_raw( __m512i   v,
+                                      __m512i * d ) {
+  __m512i const magic = _mm512_set1_epi64( 2614772005L ); /* ceil(2^43/3364) */
+  __m512i const c3364 = _mm512_set1_epi64( 3364L );
+  __m512i const c1130 = _mm512_set1_epi64( 1130L );
+  __m512i const c58   = _mm512_set1_epi64( 58L );
+
+  __m512i q = _mm512_srli_epi64( _mm512_mul_epu32( v, magic ), 43 );
+  __m512i r = _mm512_sub_epi64( v, _mm512_mul_epu32( q, c3364 ) );
+  d[ 0 ]    = _mm512_srli_epi64( _mm512_mul_epu32( q, magic ), 43 );
+  __m512i t = _mm512_sub_epi64( q, _mm512_mul_epu32( d[ 0 ], c3364 ) );
+  d[ 1 ]    = _mm512_srli_epi64( _mm512_mul_epu32( t, c1130 ), 16 );
+  d[ 2 ]    = _mm512_sub_epi64( t, _mm512_mul_epu32( d[ 1 ], c58 ) );
+  d[ 3 ]    = _mm512_srli_epi64( _mm512_mul_epu32( r, c1130 ), 16 );
+  d[ 4 ]    = _mm512_sub_epi64( r, _mm512_mul_epu32( d[ 3 ], c58 ) );
+}
+
+/* fd_base58_avx512_raw_to_chars maps 64 base58 digits in [0,58) to
+   their characters.  See fd_base58_avx_raw_to_chars. */
+
+static inline __m512i
+fd_base58_avx512_raw_to_chars( __m512i d ) {
+  __m512i c = _mm512_add_epi8( d, _mm512_set1_epi8( '1' ) );
+  c = _mm512_mask_add_epi8( c, _mm512_cmpgt_epu8_mask( d, _mm512_set1_epi8(  8 ) ), c, _mm512_set1_epi8( 7 ) );
+  c = _mm512_mask_add_epi8( c, _mm512_cmpgt_epu8_mask( d, _mm512_set1_epi8( 16 ) ), c, _mm512_set1_epi8( 1 ) );
+  c = _mm512_mask_add_epi8( c, _mm512_cmpgt_epu8_mask( d, _mm512_set1_epi8( 21 ) ), c, _mm512_set1_epi8( 1 ) );
+  c = _mm512_mask_add_epi8( c, _mm512_cmpgt_epu8_mask( d, _mm512_set1_epi8( 32 ) ), c, _mm512_set1_epi8( 6 ) );
+  c = _mm512_mask_add_epi8( c, _mm512_cmpgt_epu8_mask( d, _mm512_set1_epi8( 43 ) ), c, _mm512_set1_epi8( 1 ) );
+  return c;
+}
+
+/* fd_base58_avx512_invalid_mask returns a 64-bit mask with bit i set
+   if byte i of v is not a base58 character.  Uses the same nibble
+   classification as fd_base58_avx_invalid_mask. */
+
+static inline uint64_t
+fd_base58_avx512_invalid_mask( __m512i v ) {
+  __m512i const hi_tbl = _mm512_broadcast_i32x4( _mm_setr_epi8( 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04,
+                                                                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 ) );
+  __m512i const lo_tbl = _mm512_broadcast_i32x4( _mm_setr_epi8( 0x1B, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                                0x10, 0x12, 0x11, 0x15, 0x1D, 0x15, 0x15, 0x17 ) );
+  __m512i nib = _mm512_set1_epi8( 0x0F );
+  __m512i hi  = _mm512_shuffle_epi8( hi_tbl, _mm512_and_si512( _mm512_srli_epi16( v, 4 ), nib ) );
+  __m512i lo  = _mm512_shuffle_epi8( lo_tbl, _mm512_and_si512( v, nib ) );
+  return (uint64_t)_mm512_test_epi8_mask( hi, lo );
+}
+
+/* fd_base58_avx512_chars_to_raw is the inverse of
+   fd_base58_avx512_raw_to_chars.  Bytes that aren't base58 characters
+   map to garbage. */
+
+static inline __m512i
+fd_base58_avx512_chars_to_raw( __m512i c ) {
+  __m512i d = _mm512_sub_epi8( c, _mm512_set1_epi8( '1' ) );
+  d = _mm512_mask_sub_epi8( d, _mm512_cmpgt_epu8_mask( c, _mm512_set1_epi8( '9' ) ), d, _mm512_set1_epi8( 7 ) );
+  d = _mm512_mask_sub_epi8( d, _mm512_cmpgt_epu8_mask( c, _mm512_set1_epi8( 'H' ) ), d, _mm512_set1_epi8( 1 ) );
+  d = _mm512_mask_sub_epi8( d, _mm512_cmpgt_epu8_mask( c, _mm512_set1_epi8( 'N' ) ), d, _mm512_set1_epi8( 1 ) );
+  d = _mm512_mask_sub_epi8( d, _mm512_cmpgt_epu8_mask( c, _mm512_set1_epi8( 'Z' ) ), d, _mm512_set1_epi8( 6 ) );
+  d = _mm512_mask_sub_epi8( d, _mm512_cmpgt_epu8_mask( c, _mm512_set1_epi8( 'k' ) ), d, _mm512_set1_epi8( 1 ) );
+  return d;
+}
+
+/* fd_base58_avx512_leading_zero_bytes returns, for each u64 lane, the
+   number of leading zero bytes of the big endian number whose 32-bit
+   limbs are held in limb[0..cnt) (most significant first, zero
+   extended in each lane). */
+
+static inline __m512i
+fd_base58_avx512_leading_zero_bytes( __m512i const * limb,
+                                     uint64_t         cnt ) {
+  __m512i  lead = _mm512_setzero_si512();
+  __mmask8 done = 0;
+  for( uint64_t i=0UL; i<cnt; i++ ) {
+    __mmask8 zero = _mm512_cmpeq_epi64_mask( limb[ i ], _mm512_setzero_si512() );
+    __m512i  lz   = _mm512_srli_epi64( _mm512_sub_epi64( _mm512_lzcnt_epi64( limb[ i ] ), _mm512_set1_epi64( 32L ) ), 3 );
+    lead  = _mm512_mask_add_epi64( lead, (__mmask8)( zero & ~done), lead, _mm512_set1_epi64( 4L ) );
+    lead  = _mm512_mask_add_epi64( lead, (__mmask8)(~zero & ~done), lead, lz );
+    done |= (__mmask8)~zero;
+  }
+  return lead;
+}
+
+/* fd_base58_avx512_leading_zero_digits is the same for words[0..cnt),
+   where each u64 lane holds 8 base58 digits in memory order (so the
+   first digit is the least significant byte). */
+
+static inline __m512i
+fd_base58_avx512_leading_zero_digits( __m512i const * word,
+                                      uint64_t         cnt ) {
+  __m512i  lead = _mm512_setzero_si512();
+  __mmask8 done = 0;
+  for( uint64_t i=0UL; i<cnt; i++ ) {
+    __mmask8 zero   = _mm512_cmpeq_epi64_mask( word[ i ], _mm512_setzero_si512() );
+    __m512i  lowest = _mm512_and_si512( word[ i ], _mm512_sub_epi64( _mm512_setzero_si512(), word[ i ] ) );
+    __m512i  tz     = _mm512_srli_epi64( _mm512_sub_epi64( _mm512_set1_epi64( 63L ), _mm512_lzcnt_epi64( lowest ) ), 3 );
+    lead  = _mm512_mask_add_epi64( lead, (__mmask8)( zero & ~done), lead, _mm512_set1_epi64( 8L ) );
+    lead  = _mm512_mask_add_epi64( lead, (__mmask8)(~zero & ~done), lead, tz );
+    done |= (__mmask8)~zero;
+  }
+  return lead;
+}
+
+#endif /* HEADER_fd_base58_avx512_h */
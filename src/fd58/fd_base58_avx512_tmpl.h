@@ -0,0 +1,303 @@
+/* Declares AVX-512 batch conversion functions for a specific size of
+   binary data.  These convert 8 independent inputs at a time, one per
+   u64 lane: the inputs are transposed so that each vector holds the
+   same limb of 8 different inputs, and then the same steps as in
+   fd_base58_tmpl.h run in lockstep across the lanes.  This trades
+   latency for throughput.
+
+   Takes the same parameters as fd_base58_tmpl.h (except KERNEL), and
+   must be included from a region compiled with
+   FD_BASE58_TARGET_PUSH( FD_BASE58_AVX512 ).
+
+   This file is safe for inclusion multiple times. */
+
+#define BYTE_CNT     ((uint64_t) N)
+#define BATCH(s)     FD_EXPAND_THEN_CONCAT4(s,_,N,_batch_avx512)
+#define LOCAL(s)     FD_EXPAND_THEN_CONCAT3(s,_,N)
+#define TABLE(s)     FD_EXPAND_THEN_CONCAT3(s,_,N)
+#define ENCODED_SZ() FD_EXPAND_THEN_CONCAT3(FD_BASE58_ENCODED_, N, _SZ)
+#define RAW58_SZ     (INTERMEDIATE_SZ*5UL)
+#define RAW58_WORDS  ((RAW58_SZ+7UL)/8UL)
+
+/* encode8 converts the 8 inputs at bytes (stored contiguously) to
+   base58, storing them at out with a stride of ENCODED_SZ().  If len
+   is non-NULL, len[i] is set to the length of the i-th output. */
+
+static inline void
+LOCAL(fd_base58_avx512_encode8)( unsigned char const * bytes,
+                                 unsigned            * len,
+                                 char                * out ) {
+
+  /* Transpose to 32-bit limbs: lane k of binary[i] is limb i of the k-th
+     input (see fd_base58_tmpl.h for the limb layout). */
+
+  __m512i const in_idx = _mm512_setr_epi64( 0L*N, 1L*N, 2L*N, 3L*N, 4L*N, 5L*N, 6L*N, 7L*N );
+  __m256i const bswap  = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+
+  __m512i binary[ BINARY_SZ ];
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ ) {
+    __m256i limb = _mm512_i64gather_epi32( _mm512_add_epi64( in_idx, _mm512_set1_epi64( (long long)(4UL*i) ) ), bytes, 1 );
+    binary[ i ] = _mm512_cvtepu32_epi64( _mm256_shuffle_epi8( limb, bswap ) );
+  }
+
+  /* Convert to the intermediate format.  Entries of enc_table left of
+     the diagonal are zero, so skip them.  The sums are otherwise the
+     same as in fd_base58_tmpl.h, including the N==64 mini-reduction,
+     so the same overflow analysis applies. */
+
+  __m512i intermediate[ INTERMEDIATE_SZ ];
+  for( uint64_t j=0UL; j<INTERMEDIATE_SZ; j++ ) intermediate[ j ] = _mm512_setzero_si512();
+
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ ) {
+#   if N==64
+    if( i==8UL ) {
+      __m512i q;
+      intermediate[ 16 ] = fd_base58_avx512_divmod( intermediate[ 16 ], &q );
+      intermediate[ 15 ] = _mm512_add_epi64( intermediate[ 15 ], q );
+    }
+#   endif
+    for( uint64_t j=i; j<INTERMEDIATE_SZ-1UL; j++ )
+      intermediate[ j+1UL ] = _mm512_add_epi64( intermediate[ j+1UL ],
+          _mm512_mul_epu32( binary[ i ], _mm512_set1_epi64( (long long)TABLE(enc_table)[ i ][ j ] ) ) );
+  }
+
+  /* Make sure each term is less than 58^5 */
+
+  for( uint64_t i=INTERMEDIATE_SZ-1UL; i>0UL; i-- ) {
+    __m512i q;
+    intermediate[ i     ] = fd_base58_avx512_divmod( intermediate[ i ], &q );
+    intermediate[ i-1UL ] = _mm512_add_epi64( intermediate[ i-1UL ], q );
+  }
+
+  /* Convert to base 58, packing 8 consecutive digits of each input in
+     each u64 lane of word. */
+
+  __m512i word[ RAW58_WORDS ];
+  for( uint64_t m=0UL; m<RAW58_WORDS; m++ ) word[ m ] = _mm512_setzero_si512();
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    __m512i d[ 5 ];
+    fd_base58_avx512_intermediate_to_raw( intermediate[ i ], d );
+    for( uint64_t k=0UL; k<5UL; k++ ) {
+      uint64_t pos = 5UL*i+k;
+      word[ pos/8UL ] = _mm512_or_si512( word[ pos/8UL ], _mm512_slli_epi64( d[ k ], (unsigned)(8UL*(pos%8UL)) ) );
+    }
+  }
+
+  /* Work out how much of raw_base58 to skip, as in fd_base58_tmpl.h.  All
+     zero words cover positions past RAW58_SZ, hence the min. */
+
+  __m512i in_leading_0s  = fd_base58_avx512_leading_zero_bytes ( binary, BINARY_SZ   );
+  __m512i raw_leading_0s = fd_base58_avx512_leading_zero_digits( word,   RAW58_WORDS );
+  raw_leading_0s = _mm512_min_epu64( raw_leading_0s, _mm512_set1_epi64( (long long)RAW58_SZ ) );
+
+  uint64_t skip[ 8 ];
+  _mm512_storeu_si512( skip, _mm512_sub_epi64( raw_leading_0s, in_leading_0s ) );
+
+  /* Transpose back to one string per input */
+
+  uint8_t        chars[ 8 ][ 8UL*RAW58_WORDS ];
+  __m512i const  out_idx = _mm512_setr_epi64( 0L*8L*RAW58_WORDS, 1L*8L*RAW58_WORDS, 2L*8L*RAW58_WORDS, 3L*8L*RAW58_WORDS,
+                                              4L*8L*RAW58_WORDS, 5L*8L*RAW58_WORDS, 6L*8L*RAW58_WORDS, 7L*8L*RAW58_WORDS );
+  for( uint64_t m=0UL; m<RAW58_WORDS; m++ )
+    _mm512_i64scatter_epi64( chars, _mm512_add_epi64( out_idx, _mm512_set1_epi64( (long long)(8UL*m) ) ),
+                             fd_base58_avx512_raw_to_chars( word[ m ] ), 1 );
+
+  /* Each output is at least BYTE_CNT>=32 characters long, so it can be
+     copied with 32-byte moves, the last of which might overlap. */
+
+  for( uint64_t k=0UL; k<8UL; k++ ) {
+    uint8_t const * src = chars[ k ] + skip[ k ];
+    char *          dst = out + k*ENCODED_SZ();
+    uint64_t        l   = RAW58_SZ - skip[ k ];
+    for( uint64_t off=0UL; off+32UL<l; off+=32UL ) memcpy( dst+off, src+off, 32UL );
+    memcpy( dst+l-32UL, src+l-32UL, 32UL );
+    dst[ l ] = '\0';
+    if( len ) len[ k ] = (unsigned)l;
+  }
+}
+
+char *
+BATCH(fd_base58_encode)( unsigned char const * bytes,
+                         unsigned long         cnt,
+                         unsigned            * opt_len,
+                         char                * out ) {
+  uint64_t i = 0UL;
+  for( ; i+8UL<=cnt; i+=8UL )
+    LOCAL(fd_base58_avx512_encode8)( bytes+i*BYTE_CNT, opt_len ? opt_len+i : NULL, out+i*ENCODED_SZ() );
+
+  /* Do the leftovers through a zero padded copy */
+
+  if( i<cnt ) {
+    uint64_t      rem = cnt-i;
+    unsigned char tail_bytes[ 8UL*BYTE_CNT ];
+    char          tail_out  [ 8UL*ENCODED_SZ() ];
+    unsigned      tail_len  [ 8UL ];
+    memset( tail_bytes, 0, sizeof(tail_bytes) );
+    memcpy( tail_bytes, bytes+i*BYTE_CNT, rem*BYTE_CNT );
+    LOCAL(fd_base58_avx512_encode8)( tail_bytes, tail_len, tail_out );
+    memcpy( out+i*ENCODED_SZ(), tail_out, rem*ENCODED_SZ() );
+    if( opt_len ) memcpy( opt_len+i, tail_len, rem*sizeof(unsigned) );
+  }
+  return out;
+}
+
+/* decode8 converts the base58 cstrs encoded[0..lane_cnt), where
+   lane_cnt<=8, storing the i-th result at out+i*BYTE_CNT.  Returns a
+   mask with bit i set if the i-th input is valid, in the same sense as
+   fd_base58_decode_N.  Outputs of invalid inputs are clobbered. */
+
+#define IN_VEC_CNT ((ENCODED_SZ()+63UL)/64UL)
+#define ROW_SZ     ((RAW58_SZ+3UL+7UL)&~7UL) /* the limb gathers read 3 bytes past RAW58_SZ */
+
+static inline __mmask8
+LOCAL(fd_base58_avx512_decode8)( char const * const * encoded,
+                                 uint64_t             lane_cnt,
+                                 unsigned char      * out ) {
+
+  /* Validate each input and store its digits right aligned in a row of
+     raw, so that row k is the raw_base58 of fd_base58_tmpl.h for the
+     k-th input.  Lanes past lane_cnt decode the empty string, and get
+     masked off at the end. */
+
+  uint8_t  raw[ 8 ][ ROW_SZ ];
+  uint64_t leading_1_cnt[ 8 ];
+  __mmask8 ok = 0;
+  memset( raw, 0, sizeof(raw) );
+
+  for( uint64_t k=0UL; k<8UL; k++ ) {
+    char const * s = k<lane_cnt ? encoded[ k ] : NULL;
+
+    /* Like strlen, read past the nul terminator as long as that can't
+       cross into another page, otherwise copy into a buffer first.  The
+       lanes past lane_cnt have no string to read at all. */
+
+    __m512i in[ IN_VEC_CNT ];
+    if( FD_UNLIKELY( !s ) ) {
+      for( uint64_t v=0UL; v<IN_VEC_CNT; v++ ) in[ v ] = _mm512_setzero_si512();
+    } else if( FD_LIKELY( ((uintptr_t)s & 4095UL) <= 4096UL-64UL*IN_VEC_CNT ) ) {
+      for( uint64_t v=0UL; v<IN_VEC_CNT; v++ ) in[ v ] = _mm512_loadu_si512( s+64UL*v );
+    } else {
+      char buf[ 64UL*IN_VEC_CNT ];
+      memset( buf, 0, sizeof(buf) );
+      for( uint64_t i=0UL; i<ENCODED_SZ() && s[ i ]; i++ ) buf[ i ] = s[ i ];
+      for( uint64_t v=0UL; v<IN_VEC_CNT; v++ ) in[ v ] = _mm512_loadu_si512( buf+64UL*v );
+    }
+
+    uint64_t char_cnt = ENCODED_SZ();
+    for( uint64_t v=0UL; v<IN_VEC_CNT; v++ ) {
+      uint64_t nul = (uint64_t)_mm512_cmpeq_epi8_mask( in[ v ], _mm512_setzero_si512() );
+      if( nul ) { char_cnt = 64UL*v + (uint64_t)__builtin_ctzll( nul ); break; }
+    }
+
+    /* The nul terminator isn't a '1', so this stops at or before it */
+
+    leading_1_cnt[ k ] = 0UL;
+    for( uint64_t v=0UL; v<IN_VEC_CNT; v++ ) {
+      uint64_t not_1 = ~(uint64_t)_mm512_cmpeq_epi8_mask( in[ v ], _mm512_set1_epi8( '1' ) );
+      if( not_1 ) { leading_1_cnt[ k ] += (uint64_t)__builtin_ctzll( not_1 ); break; }
+      leading_1_cnt[ k ] += 64UL;
+    }
+
+    if( FD_UNLIKELY( char_cnt>=ENCODED_SZ() ) ) continue; /* too long */
+
+    uint64_t valid[ IN_VEC_CNT ];
+    uint64_t invalid = 0UL;
+    for( uint64_t v=0UL; v<IN_VEC_CNT; v++ ) {
+      uint64_t rem = char_cnt-64UL*v;
+      valid[ v ] = char_cnt<=64UL*v ? 0UL : rem>=64UL ? ~0UL : (1UL<<rem)-1UL;
+      invalid   |= fd_base58_avx512_invalid_mask( in[ v ] ) & valid[ v ];
+    }
+    if( FD_UNLIKELY( invalid ) ) continue;
+
+    uint8_t * row = raw[ k ] + RAW58_SZ - char_cnt;
+    for( uint64_t v=0UL; v<IN_VEC_CNT; v++ )
+      _mm512_mask_storeu_epi8( row+64UL*v, (__mmask64)valid[ v ], fd_base58_avx512_chars_to_raw( in[ v ] ) );
+    ok = (__mmask8)( ok | (1U<<k) );
+  }
+
+  /* Transpose to the intermediate format: lane k of intermediate[i] is
+     the value of digits raw[k][5i..5i+4]. */
+
+  __m512i const row_idx = _mm512_setr_epi64( 0L*ROW_SZ, 1L*ROW_SZ, 2L*ROW_SZ, 3L*ROW_SZ,
+                                             4L*ROW_SZ, 5L*ROW_SZ, 6L*ROW_SZ, 7L*ROW_SZ );
+
+  __m512i intermediate[ INTERMEDIATE_SZ ];
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    __m512i g = _mm512_i64gather_epi64( _mm512_add_epi64( row_idx, _mm512_set1_epi64( (long long)(5UL*i) ) ), raw, 1 );
+    __m512i p = _mm512_maddubs_epi16( g, _mm512_set1_epi16( 58 | (1<<8) ) );    /* d0*58+d1, d2*58+d3 */
+    __m512i q = _mm512_madd_epi16   ( p, _mm512_set1_epi32( 3364 | (1<<16) ) ); /* d0..d3 in the low u32 */
+    intermediate[ i ] = _mm512_add_epi64( _mm512_mul_epu32( q, _mm512_set1_epi64( 58L ) ),
+                                          _mm512_and_si512( _mm512_srli_epi64( g, 32 ), _mm512_set1_epi64( 0xFFL ) ) );
+  }
+
+  /* Using the table, convert to overcomplete base 2^32.  Row i of
+     dec_table is 58^(5*(INTERMEDIATE_SZ-1-i)), which is less than
+     2^(32*(BINARY_SZ-i*BINARY_SZ/INTERMEDIATE_SZ)), so the entries left
+     of that are zero and get skipped.  The sums are otherwise the same
+     as in fd_base58_tmpl.h, so the same overflow analysis applies. */
+
+  __m512i binary[ BINARY_SZ ];
+  for( uint64_t j=0UL; j<BINARY_SZ; j++ ) binary[ j ] = _mm512_setzero_si512();
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    for( uint64_t j=i*BINARY_SZ/INTERMEDIATE_SZ; j<BINARY_SZ; j++ )
+      binary[ j ] = _mm512_add_epi64( binary[ j ],
+          _mm512_mul_epu32( intermediate[ i ], _mm512_set1_epi64( (long long)TABLE(dec_table)[ i ][ j ] ) ) );
+  }
+
+  /* Make sure each term is less than 2^32, and flag the lanes where
+     the number doesn't fit in BYTE_CNT bytes. */
+
+  for( uint64_t i=BINARY_SZ-1UL; i>0UL; i-- ) {
+    binary[ i-1UL ] = _mm512_add_epi64( binary[ i-1UL ], _mm512_srli_epi64( binary[ i ], 32 ) );
+    binary[ i     ] = _mm512_and_si512( binary[ i ], _mm512_set1_epi64( 0xFFFFFFFFL ) );
+  }
+  ok = (__mmask8)( ok & _mm512_cmple_epu64_mask( binary[ 0 ], _mm512_set1_epi64( 0xFFFFFFFFL ) ) );
+
+  /* The number of leading '1's must match the number of leading zero
+     bytes of the output. */
+
+  __m512i leading_zero_cnt = fd_base58_avx512_leading_zero_bytes( binary, BINARY_SZ );
+  ok = (__mmask8)( ok & _mm512_cmpeq_epi64_mask( leading_zero_cnt, _mm512_loadu_si512( leading_1_cnt ) ) );
+
+  /* Transpose back, converting to big endian */
+
+  __m512i const out_idx = _mm512_setr_epi64( 0L*N, 1L*N, 2L*N, 3L*N, 4L*N, 5L*N, 6L*N, 7L*N );
+  __m256i const bswap   = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+  __mmask8 lanes = (__mmask8)( (1U<<lane_cnt)-1U );
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ )
+    _mm512_mask_i64scatter_epi32( out+4UL*i, lanes, out_idx, _mm256_shuffle_epi8( _mm512_cvtepi64_epi32( binary[ i ] ), bswap ), 1 );
+
+  return (__mmask8)( ok & lanes );
+}
+
+#undef ROW_SZ
+#undef IN_VEC_CNT
+
+unsigned long
+BATCH(fd_base58_decode)( char const * const * encoded,
+                         unsigned long        cnt,
+                         unsigned char *      out,
+                         unsigned char *      opt_valid ) {
+  unsigned long valid_cnt = 0UL;
+  for( uint64_t i=0UL; i<cnt; i+=8UL ) {
+    uint64_t lane_cnt = cnt-i<8UL ? cnt-i : 8UL;
+    __mmask8 ok       = LOCAL(fd_base58_avx512_decode8)( encoded+i, lane_cnt, out+i*BYTE_CNT );
+    valid_cnt += (unsigned long)__builtin_popcount( (unsigned)ok );
+    if( opt_valid ) for( uint64_t k=0UL; k<lane_cnt; k++ ) opt_valid[ i+k ] = (unsigned char)( (ok>>k)&1U );
+  }
+  return valid_cnt;
+}
+
+#undef RAW58_WORDS
+#undef RAW58_SZ
+#undef ENCODED_SZ
+#undef TABLE
+#undef LOCAL
+#undef BATCH
+
+#undef BINARY_SZ
+#undef BYTE_CNT
+#undef INTERMEDIATE_SZ
+#undef N
@@ -0,0 +1,103 @@
+/* AVX-512 IFMA kernels, see fd_base58_tmpl.h and fd_base58_ifma.h.
+   The dispatch in fd_base58.c only calls them on CPUs that support the
+   extensions in FD_BASE58_IFMA. */
+
+#include "fd_base58_private.h"
+
+#if FD_HAS_X86
+
+FD_BASE58_TARGET_PUSH( FD_BASE58_IFMA )
+
+#include "fd_base58_avx.h"
+#include "fd_base58_avx512.h"
+#include "fd_base58_ifma.h"
+
+#define FD_HAS_AVX  1
+#define FD_HAS_IFMA 1
+#define KERNEL      ifma
+
+#define N                32
+#define INTERMEDIATE_SZ (9UL)
+#define BINARY_SZ       ((uint64_t)N/4UL)
+
+/* Contains the unique values less than 58^5 such that:
+     2^(52*(4-j)) = sum_k table[j][k]*58^(5*(8-k))
+   Rows are padded with zeros to whole vectors. */
+
+static uint64_t const enc52_table_32[5][16] __attribute__((aligned(64))) = {
+  {        0UL,         7UL, 550667440UL, 502289454UL, 590921969UL, 218521078UL, 449746271UL, 329522580UL, 147129216UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,       749UL, 563670112UL, 369434287UL, 469620603UL, 425716400UL,  59086336UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,     71729UL, 527870455UL, 584944171UL, 192414240UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,   6861511UL, 443814048UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         1UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL}
+};
+
+/* Contains the unique values less than 2^52 such that:
+     58^(5*(8-j)) = sum_k table[j][k]*2^(52*(4-k))
+   Rows are padded with zeros to whole vectors. */
+
+static uint64_t const dec52_table_32[9][8] __attribute__((aligned(64))) = {
+  {        83729913UL, 3869723270665047UL, 3277233502395464UL, 4049017788381958UL,  317758860427264UL,                0UL,                0UL,                0UL},
+  {               0UL,  574513781590635UL, 1590801793269904UL, 2199566205420663UL, 2496063193743360UL,                0UL,                0UL,                0UL},
+  {               0UL,           875307UL,  741474571213368UL, 1265285701333454UL, 2998773009612800UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,    6005930330422UL, 2758050106434950UL, 2801594181615616UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,             9150UL, 1824498066688426UL, 4310442080993280UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,      62785611572UL, 1409406172037120UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,               95UL, 2962242299208704UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,        656356768UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                1UL,                0UL,                0UL,                0UL}
+};
+
+#include "fd_base58_tmpl.h"
+
+#define N                64
+#define INTERMEDIATE_SZ (18UL)
+#define BINARY_SZ       ((uint64_t)N/4UL)
+
+/* Contains the unique values less than 58^5 such that:
+     2^(52*(9-j)) = sum_k table[j][k]*58^(5*(17-k))
+   Rows are padded with zeros to whole vectors. */
+
+static uint64_t const enc52_table_64[10][24] __attribute__((aligned(64))) = {
+  {        0UL,         0UL, 421636746UL, 341939960UL, 427843872UL, 507831179UL, 170553025UL, 348652084UL, 293664278UL, 163380196UL, 298973999UL, 191490987UL, 289649177UL, 442478329UL,  78047805UL, 484063438UL, 172260198UL, 141445696UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,        61UL, 295059608UL, 141201404UL, 517024870UL, 239296485UL, 527697587UL, 212906911UL, 453637228UL, 467589845UL, 144614682UL,  45134568UL, 184514320UL, 644355351UL, 104784612UL, 308625792UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,      5878UL,  81961821UL, 345880098UL, 171253552UL,  38393073UL, 441894667UL, 250503419UL, 193013911UL, 334397277UL, 459733446UL, 216399954UL, 328895570UL, 356764352UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,    562288UL, 130740298UL, 147241268UL, 553330405UL, 470224919UL, 648159646UL, 469972204UL, 363842761UL, 448067151UL, 173439274UL, 635074496UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,  53787223UL, 618120192UL, 495642092UL, 347228068UL, 487688611UL, 655243859UL, 216479247UL, 172044172UL, 184037504UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         7UL, 550667440UL, 502289454UL, 590921969UL, 218521078UL, 449746271UL, 329522580UL, 147129216UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,       749UL, 563670112UL, 369434287UL, 469620603UL, 425716400UL,  59086336UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,     71729UL, 527870455UL, 584944171UL, 192414240UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,   6861511UL, 443814048UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL},
+  {        0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL,         1UL,         0UL,         0UL,         0UL,         0UL,         0UL,         0UL}
+};
+
+/* Contains the unique values less than 2^52 such that:
+     58^(5*(17-j)) = sum_k table[j][k]*2^(52*(9-k))
+   Rows are padded with zeros to whole vectors. */
+
+static uint64_t const dec52_table_64[18][16] __attribute__((aligned(64))) = {
+  {      1021742555UL, 2426626631380478UL, 4216908451388280UL,   74306901465917UL, 3349980040820079UL,  814666414546487UL, 1426662760038670UL, 1766798422431184UL, 1941574325895168UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               1UL, 2507098847507125UL, 4329262770540607UL, 3127681385378935UL, 2396291706765308UL,  515911787670544UL,  358399201025081UL, 3039051886618456UL, 1020776555741184UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,         10681231UL, 1492078351152862UL, 2760813205716863UL, 3545347855482718UL, 1002635677308919UL,  442844269594498UL, 2960668689465266UL, 3206299160412160UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,   73289393495728UL, 1987274476675916UL, 2832150970948092UL, 2199179033121472UL, 2599633273287788UL, 3177481102511247UL, 3574944321765376UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,           111660UL, 4094818759699180UL, 4478414562862227UL, 3797315772341640UL,  122968393342999UL, 3512481030483200UL, 1118872235384832UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,     766162632470UL, 3898886458696192UL, 3103615784719424UL, 1953374282224321UL, 3659777012946455UL, 4407098450587904UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,             1167UL, 1333083408798271UL, 1669393499713748UL, 4467833040122869UL, 1463865213868797UL, 2402209693581480UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,       8009415160UL, 3858668684922727UL, 4064841999145251UL, 1063369779849405UL, 2636344929945922UL, 1125899906842624UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,               12UL,  913500117130555UL, 4479144814843469UL,  999390944747968UL, 4196518529189240UL, 2709196650840064UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,         83729913UL, 3869723270665047UL, 3277233502395464UL, 4049017788381958UL,  317758860427264UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,  574513781590635UL, 1590801793269904UL, 2199566205420663UL, 2496063193743360UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,           875307UL,  741474571213368UL, 1265285701333454UL, 2998773009612800UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,    6005930330422UL, 2758050106434950UL, 2801594181615616UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,             9150UL, 1824498066688426UL, 4310442080993280UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,      62785611572UL, 1409406172037120UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,               95UL, 2962242299208704UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,        656356768UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL},
+  {               0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL,                1UL,                0UL,                0UL,                0UL,                0UL,                0UL,                0UL}
+};
+
+#include "fd_base58_tmpl.h"
+
+FD_BASE58_TARGET_POP()
+
+#endif /* FD_HAS_X86 */
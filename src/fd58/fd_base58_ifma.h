@@ -0,0 +1,81 @@
+#ifndef HEADER_fd_base58_ifma_h
+#define HEADER_fd_base58_ifma_h
+
+/* AVX-512 IFMA helpers used by fd_base58_tmpl.h when FD_HAS_IFMA is
+   set.  Only include this from a region compiled with
+   FD_BASE58_TARGET_PUSH( FD_BASE58_IFMA ).
+
+   vpmadd52{lu,hu}q multiply the low 52 bits of each u64 lane and add
+   the low (lu) or high (hu) 52 bits of the 104-bit product to the
+   accumulator.  As long as both factors are less than 2^52, the two
+   halves together are the exact product. */
+
+#include <immintrin.h>
+
+#define FD_BASE58_IFMA_MASK52 ((1UL<<52)-1UL)
+
+/* fd_base58_ifma_bytes_to_limbs52 converts the byte_cnt byte big endian
+   number at bytes (byte_cnt a multiple of 8) to limb_cnt 52-bit limbs,
+   most significant first:
+     X = sum_i limb[i] * 2^(52*(limb_cnt-1-i))
+   52*limb_cnt must be at least 8*byte_cnt.  Limb i (counting from the
+   least significant) is made of the words holding bits 52*i through
+   52*i+51.  The counts are compile time constants at every call site,
+   so the loops fully unroll into shifts. */
+
+static inline void
+fd_base58_ifma_bytes_to_limbs52( uint8_t const * bytes,
+                                 uint64_t        byte_cnt,
+                                 uint64_t *      limb,
+                                 uint64_t        limb_cnt ) {
+  uint64_t word_cnt = byte_cnt/8UL;
+  uint64_t word[ 8 ];
+  for( uint64_t w=0UL; w<word_cnt; w++ ) {
+    uint64_t x;
+    memcpy( &x, bytes+8UL*(word_cnt-1UL-w), sizeof(uint64_t) );
+    word[ w ] = __builtin_bswap64( x );
+  }
+
+  for( uint64_t i=0UL; i<limb_cnt; i++ ) {
+    uint64_t w = 52UL*i/64UL;
+    uint64_t s = 52UL*i%64UL;
+    uint64_t x = word[ w ] >> s;
+    if( w+1UL<word_cnt && s>12UL ) x |= word[ w+1UL ] << (64UL-s);
+    limb[ limb_cnt-1UL-i ] = x & FD_BASE58_IFMA_MASK52;
+  }
+}
+
+/* fd_base58_ifma_limbs52_to_bytes is the inverse.  Every limb must be
+   less than 2^52, and the number must fit in byte_cnt bytes.  Word w
+   (counting from the least significant) is made of the limbs starting
+   at bits 64*w through 64*w+63. */
+
+static inline void
+fd_base58_ifma_limbs52_to_bytes( uint64_t const * limb,
+                                 uint64_t         limb_cnt,
+                                 uint8_t *        bytes,
+                                 uint64_t         byte_cnt ) {
+  uint64_t word_cnt = byte_cnt/8UL;
+  for( uint64_t w=0UL; w<word_cnt; w++ ) {
+    uint64_t i = 64UL*w/52UL;   /* First limb in the word, from the least significant */
+    uint64_t s = 64UL*w%52UL;   /* Bits of it that belong to word w-1 */
+    uint64_t x = limb[ limb_cnt-1UL-i ] >> s;
+    if( i+1UL<limb_cnt ) x |= limb[ limb_cnt-2UL-i ] << (52UL-s);
+    if( i+2UL<limb_cnt && s>40UL ) x |= limb[ limb_cnt-3UL-i ] << (104UL-s);
+    x = __builtin_bswap64( x );
+    memcpy( bytes+8UL*(word_cnt-1UL-w), &x, sizeof(uint64_t) );
+  }
+}
+
+/* fd_base58_ifma_next_lane returns the vector whose lane k is lane k+1
+   of the 16 lane concatenation of cur (lanes 0-7) and next (lanes
+   8-15).  This moves the high half of the products in column j+1 to
+   column j. */
+
+static inline __m512i
+fd_base58_ifma_next_lane( __m512i cur,
+                          __m512i next ) {
+  return _mm512_alignr_epi64( next, cur, 1 );
+}
+
+#endif /* HEADER_fd_base58_ifma_h */
@@ -0,0 +1,146 @@
+#ifndef HEADER_fd_base58_private_h
+#define HEADER_fd_base58_private_h
+
+/* Declarations shared between the translation units that implement the
+   base58 kernels.  Nothing in here is part of the public API. */
+
+#include "fd_base58.h"
+#include <stdint.h>
+#include <string.h>
+
+#define FD_STRINGIFY(x)#x
+#define FD_CONCAT2(a,b)a##b
+#define FD_CONCAT3(a,b,c)a##b##c
+#define FD_CONCAT4(a,b,c,d)a##b##c##d
+
+#define FD_EXPAND_THEN_STRINGIFY(x)FD_STRINGIFY(x)
+#define FD_EXPAND_THEN_CONCAT2(a,b)FD_CONCAT2(a,b)
+#define FD_EXPAND_THEN_CONCAT3(a,b,c)FD_CONCAT3(a,b,c)
+#define FD_EXPAND_THEN_CONCAT4(a,b,c,d)FD_CONCAT4(a,b,c,d)
+
+#define FD_LIKELY(c)   __builtin_expect( !!(c), 1L )
+#define FD_UNLIKELY(c) __builtin_expect( !!(c), 0L )
+
+/* FD_HAS_X86 is 1 when compiling for x86-64, where the vector kernels
+   are available (subject to a runtime check of the CPU). */
+
+#if defined(__x86_64__)
+#define FD_HAS_X86 1
+#else
+#define FD_HAS_X86 0
+#endif
+
+/* FD_HAS_INT128 is 1 when the compiler supports unsigned __int128,
+   which the wide kernels need. */
+
+#if defined(__SIZEOF_INT128__)
+#define FD_HAS_INT128 1
+#else
+#define FD_HAS_INT128 0
+#endif
+
+/* FD_BASE58_TARGET_{PUSH,POP} bracket a region of a translation unit
+   that is compiled for a specific instruction set extension (e.g.
+   "avx2").  Functions in that region must only be called after a
+   runtime check that the CPU supports it. */
+
+#if defined(__clang__)
+#define FD_BASE58_TARGET_PUSH(t) _Pragma(FD_STRINGIFY(clang attribute push (__attribute__((target(t))), apply_to=function)))
+#define FD_BASE58_TARGET_POP()   _Pragma("clang attribute pop")
+#else
+#define FD_BASE58_TARGET_PUSH(t) _Pragma("GCC push_options") _Pragma(FD_STRINGIFY(GCC target(t)))
+#define FD_BASE58_TARGET_POP()   _Pragma("GCC pop_options")
+#endif
+
+/* FD_BASE58_AVX512 is the target for the AVX-512 kernels.  AVX512DQ is
+   for u64 <-> double conversions and 64-bit multiplies, AVX512BW for
+   byte-wise ops and AVX512CD for lzcnt. */
+
+#define FD_BASE58_AVX512 "avx2,avx512f,avx512dq,avx512bw,avx512cd"
+
+/* FD_BASE58_IFMA is the target for the IFMA kernels, which also use the
+   AVX2 and AVX-512 helpers. */
+
+#define FD_BASE58_IFMA FD_BASE58_AVX512 ",avx512ifma"
+
+/* FD_BASE58_ADX is the target for the adx kernels (mulx and
+   adcx/adox). */
+
+#define FD_BASE58_ADX "bmi2,adx"
+
+extern char const base58_chars[];
+
+#define BASE58_INVALID_CHAR           ((uint8_t)255)
+#define BASE58_INVERSE_TABLE_OFFSET   ((uint8_t)'1')
+#define BASE58_INVERSE_TABLE_SENTINEL ((uint8_t)(1UL + (uint8_t)('z')-BASE58_INVERSE_TABLE_OFFSET))
+
+extern uint8_t const base58_inverse[];
+
+/* Conversion tables, see fd_base58.c for their definitions.  Row j of
+   enc_table_32 is 2^(32*(7-j)) in base 58^5, which is row 8+j of
+   enc_table_64 (from column 9 on, the ones before are zero), and
+   likewise for dec_table_32, so the N==32 tables are views into the
+   N==64 ones with the same row stride. */
+
+extern uint32_t const enc_table_64[ 16 ][ 17 ] __attribute__((aligned(64)));
+extern uint32_t const dec_table_64[ 18 ][ 16 ] __attribute__((aligned(64)));
+
+#define enc_table_32 ((uint32_t const (*)[ 17 ])&enc_table_64[ 8 ][ 9 ]) /* [  8 ][  8 ] */
+#define dec_table_32 ((uint32_t const (*)[ 16 ])&dec_table_64[ 9 ][ 8 ]) /* [  9 ][  8 ] */
+
+/* FD_BASE58_CSTR is the len the decode kernels' front ends take for a
+   nul terminated input, for which they find the length themselves. */
+
+#define FD_BASE58_CSTR (~0UL)
+
+/* Kernels.  Each has the same contract as the public function of the
+   same name without the kernel suffix. */
+
+char *          fd_base58_encode_32_scalar    ( unsigned char const * bytes, unsigned * opt_len, char * out );
+char *          fd_base58_encode_64_scalar    ( unsigned char const * bytes, unsigned * opt_len, char * out );
+unsigned char * fd_base58_decode_32_scalar    ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_64_scalar    ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_32_len_scalar( char const * encoded, unsigned long len, unsigned char * out );
+unsigned char * fd_base58_decode_64_len_scalar( char const * encoded, unsigned long len, unsigned char * out );
+
+#if FD_HAS_INT128
+char *          fd_base58_encode_32_wide      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+char *          fd_base58_encode_64_wide      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+unsigned char * fd_base58_decode_32_wide      ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_64_wide      ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_32_len_wide  ( char const * encoded, unsigned long len, unsigned char * out );
+unsigned char * fd_base58_decode_64_len_wide  ( char const * encoded, unsigned long len, unsigned char * out );
+#endif
+
+#if FD_HAS_X86
+char *          fd_base58_encode_32_avx2      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+char *          fd_base58_encode_64_avx2      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+unsigned char * fd_base58_decode_32_avx2      ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_64_avx2      ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_32_len_avx2  ( char const * encoded, unsigned long len, unsigned char * out );
+unsigned char * fd_base58_decode_64_len_avx2  ( char const * encoded, unsigned long len, unsigned char * out );
+
+char *          fd_base58_encode_32_ifma      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+char *          fd_base58_encode_64_ifma      ( unsigned char const * bytes, unsigned * opt_len, char * out );
+unsigned char * fd_base58_decode_32_ifma      ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_64_ifma      ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_32_len_ifma  ( char const * encoded, unsigned long len, unsigned char * out );
+unsigned char * fd_base58_decode_64_len_ifma  ( char const * encoded, unsigned long len, unsigned char * out );
+
+#if FD_HAS_INT128
+char *          fd_base58_encode_32_adx       ( unsigned char const * bytes, unsigned * opt_len, char * out );
+char *          fd_base58_encode_64_adx       ( unsigned char const * bytes, unsigned * opt_len, char * out );
+unsigned char * fd_base58_decode_32_adx       ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_64_adx       ( char const * encoded, unsigned char * out );
+unsigned char * fd_base58_decode_32_len_adx   ( char const * encoded, unsigned long len, unsigned char * out );
+unsigned char * fd_base58_decode_64_len_adx   ( char const * encoded, unsigned long len, unsigned char * out );
+#endif
+
+char * fd_base58_encode_32_batch_avx512( unsigned char const * bytes, unsigned long cnt, unsigned * opt_len, char * out );
+char * fd_base58_encode_64_batch_avx512( unsigned char const * bytes, unsigned long cnt, unsigned * opt_len, char * out );
+
+unsigned long fd_base58_decode_32_batch_avx512( char const * const * encoded, unsigned long cnt, unsigned char * out, unsigned char * opt_valid );
+unsigned long fd_base58_decode_64_batch_avx512( char const * const * encoded, unsigned long cnt, unsigned char * out, unsigned char * opt_valid );
+#endif
+
+#endif /* HEADER_fd_base58_private_h */
@@ -0,0 +1,139 @@
+#ifndef HEADER_fd_base58_sse_h
+#define HEADER_fd_base58_sse_h
+
+/* SSE2 helpers for the decode front end of the portable kernels.  SSE2
+   is part of x86-64, so these need no target region or runtime check.
+   They are the 16 byte counterparts of the helpers in fd_base58_avx.h,
+   minus pshufb (SSSE3), so the classification uses range checks. */
+
+#include <emmintrin.h>
+
+/* fd_base58_sse_in_range returns 0xFF in each byte of c that is in
+   [lo,hi] and 0 otherwise (as unsigned bytes). */
+
+static inline __m128i
+fd_base58_sse_in_range( __m128i c,
+                        char    lo,
+                        char    hi ) {
+  __m128i t = _mm_sub_epi8( c, _mm_set1_epi8( lo ) );
+  return _mm_cmpeq_epi8( _mm_subs_epu8( t, _mm_set1_epi8( (char)(hi-lo) ) ), _mm_setzero_si128() );
+}
+
+/* fd_base58_sse_invalid_mask returns a 16-bit mask with bit i set if
+   byte i of v is not a base58 character. */
+
+static inline uint32_t
+fd_base58_sse_invalid_mask( __m128i v ) {
+  __m128i valid = _mm_or_si128( _mm_or_si128( fd_base58_sse_in_range( v, '1', '9' ), fd_base58_sse_in_range( v, 'A', 'H' ) ),
+                  _mm_or_si128( _mm_or_si128( fd_base58_sse_in_range( v, 'J', 'N' ), fd_base58_sse_in_range( v, 'P', 'Z' ) ),
+                                _mm_or_si128( fd_base58_sse_in_range( v, 'a', 'k' ), fd_base58_sse_in_range( v, 'm', 'z' ) ) ) );
+  return (uint32_t)_mm_movemask_epi8( valid ) ^ 0xFFFFU;
+}
+
+/* fd_base58_sse_chars_to_raw maps 16 base58 characters to their digits
+   in [0,58), as base58_inverse does.  Bytes that aren't base58
+   characters map to garbage.  The comparisons are signed, which is
+   fine since all the characters are below 0x80.  Each mask is 0 or -1,
+   so adding it subtracts 1. */
+
+static inline __m128i
+fd_base58_sse_chars_to_raw( __m128i c ) {
+  __m128i d = _mm_sub_epi8( c, _mm_set1_epi8( '1' ) );
+  d = _mm_sub_epi8( d, _mm_and_si128( _mm_cmpgt_epi8( c, _mm_set1_epi8( '9' ) ), _mm_set1_epi8( 7 ) ) );
+  d = _mm_add_epi8( d,                _mm_cmpgt_epi8( c, _mm_set1_epi8( 'H' ) )                          );
+  d = _mm_add_epi8( d,                _mm_cmpgt_epi8( c, _mm_set1_epi8( 'N' ) )                          );
+  d = _mm_sub_epi8( d, _mm_and_si128( _mm_cmpgt_epi8( c, _mm_set1_epi8( 'Z' ) ), _mm_set1_epi8( 6 ) ) );
+  d = _mm_add_epi8( d,                _mm_cmpgt_epi8( c, _mm_set1_epi8( 'k' ) )                          );
+  return d;
+}
+
+/* fd_base58_sse_decode_raw is the decode front end: it checks that the
+   input at encoded is shorter than encoded_sz and that every character
+   is a base58 character, and writes the digits to raw[0..raw_sz),
+   right aligned with leading zeros (raw_sz must be at least
+   encoded_sz-1).  The input is the len characters at encoded, or the
+   cstr at encoded if len is FD_BASE58_CSTR.  Returns the length, or ~0UL
+   if the input is invalid, in which case nothing past the checks has
+   run.
+
+   Each character is classified and converted once, 16 at a time, with
+   the digits stored straight to their final position.  Up to 15 bytes
+   of garbage are written after raw+raw_sz, so raw must have room for
+   raw_sz+16 bytes.  Like strlen, this reads a cstr past the nul
+   terminator as long as that can't cross into another page.  It never
+   reads past encoded+len, which must be at least 16 (a '\0' among
+   those characters is an invalid character). */
+
+#define FD_BASE58_SSE_MAX_VEC_CNT (6UL) /* Enough for FD_BASE58_ENCODED_64_SZ */
+
+static inline uint64_t
+fd_base58_sse_decode_raw( char const * encoded,
+                          uint64_t     len,
+                          uint64_t     encoded_sz,
+                          uint8_t *    raw,
+                          uint64_t     raw_sz ) {
+  uint64_t vec_cnt = (encoded_sz+15UL)/16UL;
+
+  __m128i in[ FD_BASE58_SSE_MAX_VEC_CNT ];
+  if( len!=FD_BASE58_CSTR ) {
+    if( FD_UNLIKELY( len>=encoded_sz ) ) return ~0UL; /* too long */
+
+    /* Whole vectors from the start, and if that leaves a partial one,
+       the vector that ends at the last character, stored where its
+       digits go.  Nothing to mask, as in fd_base58_tmpl.h. */
+
+    uint64_t full_cnt = len/16UL;
+    uint32_t invalid  = 0U;
+    for( uint64_t k=0UL; k<full_cnt; k++ ) {
+      in[ k ] = _mm_loadu_si128( (__m128i const *)( encoded+16UL*k ) );
+      invalid |= fd_base58_sse_invalid_mask( in[ k ] );
+    }
+    __m128i tail = _mm_loadu_si128( (__m128i const *)( encoded+len-16UL ) );
+    invalid |= fd_base58_sse_invalid_mask( tail );
+    if( FD_UNLIKELY( invalid ) ) return ~0UL;
+
+    uint64_t prepend_0 = raw_sz-len;
+    memset( raw, 0, raw_sz );
+    for( uint64_t k=0UL; k<full_cnt; k++ )
+      _mm_storeu_si128( (__m128i *)( raw+prepend_0+16UL*k ), fd_base58_sse_chars_to_raw( in[ k ] ) );
+    _mm_storeu_si128( (__m128i *)( raw+raw_sz-16UL ), fd_base58_sse_chars_to_raw( tail ) );
+    return len;
+  }
+
+  if( FD_LIKELY( ((uintptr_t)encoded & 4095UL) <= 4096UL-16UL*vec_cnt ) ) {
+    for( uint64_t k=0UL; k<vec_cnt; k++ ) in[ k ] = _mm_loadu_si128( (__m128i const *)( encoded+16UL*k ) );
+  } else {
+    char buf[ 16UL*FD_BASE58_SSE_MAX_VEC_CNT ];
+    memset( buf, 0, sizeof(buf) );
+    for( uint64_t i=0UL; i<encoded_sz && encoded[ i ]; i++ ) buf[ i ] = encoded[ i ];
+    for( uint64_t k=0UL; k<vec_cnt; k++ ) in[ k ] = _mm_loadu_si128( (__m128i const *)( buf+16UL*k ) );
+  }
+
+  uint64_t char_cnt = encoded_sz;
+  for( uint64_t k=0UL; k<vec_cnt; k++ ) {
+    uint32_t nul = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( in[ k ], _mm_setzero_si128() ) );
+    if( nul ) { char_cnt = 16UL*k + (uint64_t)__builtin_ctz( nul ); break; }
+  }
+
+  if( FD_UNLIKELY( char_cnt >= encoded_sz ) ) return ~0UL; /* too long */
+
+  /* Reject before writing anything, so garbage input costs as little
+     as possible. */
+
+  uint32_t invalid = 0U;
+  for( uint64_t k=0UL; 16UL*k<char_cnt; k++ ) {
+    uint32_t m = fd_base58_sse_invalid_mask( in[ k ] );
+    if( char_cnt-16UL*k<16UL ) m &= (1U<<(char_cnt-16UL*k))-1U;
+    invalid |= m;
+  }
+  if( FD_UNLIKELY( invalid ) ) return ~0UL;
+
+  uint64_t prepend_0 = raw_sz-char_cnt;
+  memset( raw, 0, raw_sz );
+  for( uint64_t k=0UL; 16UL*k<char_cnt; k++ )
+    _mm_storeu_si128( (__m128i *)( raw+prepend_0+16UL*k ), fd_base58_sse_chars_to_raw( in[ k ] ) );
+
+  return char_cnt;
+}
+
+#endif /* HEADER_fd_base58_sse_h */
@@ -13,6 +13,20 @@
          preprocessor can do math like that.
      BINARY_SIZE: N/4.  Define it yourself to facilitate declaring the
          required tables.
+     KERNEL: the name of the kernel flavour (e.g. scalar), appended to
+         the names of the declared functions.
+
+   If FD_HAS_AVX is set, the declared functions use AVX2 and the
+   helpers from fd_base58_avx.h, and must only be called on CPUs that
+   support it.  If FD_HAS_IFMA is also set, the table products use
+   AVX-512 IFMA on 52-bit limbs instead (see fd_base58_ifma.h), which
+   expects enc52_table_N and dec52_table_N as well.  Otherwise, on
+   x86-64, the decode front end uses the SSE2 helpers from
+   fd_base58_sse.h.
+
+   Each decode kernel comes in two flavours, one for cstrs and one
+   (suffixed _len, e.g. fd_base58_decode_32_len_scalar) for the len
+   characters at a pointer, which never reads past them.
 
    INTERMEDIATE_SZ and BINARY_SZ should expand to uint64_ts while N should
    be an integer literal.
@@ -22,18 +36,73 @@
 
    This file is safe for inclusion multiple times. */
 
-#define BYTE_CNT     ((uint64_t) N)
-#define SUFFIX(s)    FD_EXPAND_THEN_CONCAT3(s,_,N)
-#define ENCODED_SZ() FD_EXPAND_THEN_CONCAT3(FD_BASE58_ENCODED_, N, _SZ)
-#define RAW58_SZ     (INTERMEDIATE_SZ*5UL)
-
-#define INTERMEDIATE_SZ_W_PADDING INTERMEDIATE_SZ
+#define BYTE_CNT      ((uint64_t) N)
+#define SUFFIX(s)     FD_EXPAND_THEN_CONCAT4(s,_,N,FD_EXPAND_THEN_CONCAT2(_,KERNEL))
+#define SUFFIX_LEN(s) FD_EXPAND_THEN_CONCAT4(s,_,N,FD_EXPAND_THEN_CONCAT2(_len_,KERNEL))
+#define TABLE(s)      FD_EXPAND_THEN_CONCAT3(s,_,N)
+#define ENCODED_SZ()  FD_EXPAND_THEN_CONCAT3(FD_BASE58_ENCODED_, N, _SZ)
+#define RAW58_SZ      (INTERMEDIATE_SZ*5UL)
+
+/* ENC_ROW_START(i) and DEC_ROW_START(i) are lower bounds on the first
+   nonzero column of row i of enc_table and dec_table.  The entries left
+   of them are all zero, so the table products start there. */
+
+#define ENC_ROW_START(i) ((i)*(INTERMEDIATE_SZ-1UL)/BINARY_SZ)
+#define DEC_ROW_START(i) ((i)*BINARY_SZ/INTERMEDIATE_SZ)
+
+#if FD_HAS_AVX
+# define INTERMEDIATE_SZ_W_PADDING ((INTERMEDIATE_SZ+7UL)&~7UL) /* Whole u32 vectors */
+# define ENC_GRP_CNT               ((INTERMEDIATE_SZ-1UL)/4UL)  /* u64 vectors per enc_table row */
+#else
+# define INTERMEDIATE_SZ_W_PADDING INTERMEDIATE_SZ
+#endif
+
+#if FD_HAS_IFMA
+# define LIMB52_SZ            ((8UL*BYTE_CNT+51UL)/52UL)    /* 52-bit limbs needed for N bytes */
+# define LIMB52_VEC_CNT       ((LIMB52_SZ+7UL)/8UL)         /* u64 vectors per dec52_table row */
+# define INTERMEDIATE_VEC_CNT ((INTERMEDIATE_SZ+7UL)/8UL)   /* u64 vectors per enc52_table row */
+#endif
 
 char *
 SUFFIX(fd_base58_encode)( unsigned char const * bytes,
                           unsigned            * opt_len,
                           char                * out ) {
 
+#if FD_HAS_AVX
+
+  /* Load the input once.  It is used both to count leading zeros and
+     to convert to 32-bit limbs. */
+
+  __m256i  in[ BYTE_CNT/32UL ];
+  uint64_t in_zero_mask = 0UL;
+  for( uint64_t i=0UL; i<BYTE_CNT/32UL; i++ ) {
+    in[ i ] = _mm256_loadu_si256( (__m256i const *)( bytes+32UL*i ) );
+    in_zero_mask |= (uint64_t)fd_base58_avx_zero_mask( in[ i ] ) << (32UL*i);
+  }
+
+  /* Count leading zeros (needed for final output).  For N==32, the
+     upper half of ~in_zero_mask is all ones, so it's never 0. */
+
+  uint64_t in_nonzero    = ~in_zero_mask;
+  uint64_t in_leading_0s = FD_LIKELY( in_nonzero ) ? (uint64_t)__builtin_ctzll( in_nonzero ) : BYTE_CNT;
+
+  /* X = sum_i bytes[i] * 2^(8*(BYTE_CNT-1-i)) */
+
+# if FD_HAS_IFMA
+  /* Convert N to 52-bit limbs:
+     X = sum_i binary[i] * 2^(52*(LIMB52_SZ-1-i)) */
+  uint64_t binary[ LIMB52_SZ ];
+  fd_base58_ifma_bytes_to_limbs52( bytes, BYTE_CNT, binary, LIMB52_SZ );
+# else
+  /* Convert N to 32-bit limbs:
+     X = sum_i binary[i] * 2^(32*(BINARY_SZ-1-i)) */
+  uint32_t binary[ BINARY_SZ ];
+  for( uint64_t i=0UL; i<BYTE_CNT/32UL; i++ )
+    _mm256_storeu_si256( (__m256i *)( binary+8UL*i ), fd_base58_avx_bswap32( in[ i ] ) );
+# endif
+
+#else
+
   /* Count leading zeros (needed for final output) */
 
   uint64_t in_leading_0s = 0UL;
@@ -50,6 +119,8 @@ SUFFIX(fd_base58_encode)( unsigned char const * bytes,
     binary[ i ] = __builtin_bswap32( limb );
   }
 
+#endif
+
   uint64_t R1div = 656356768UL; /* = 58^5 */
 
   /* Convert to the intermediate format:
@@ -57,9 +128,100 @@ SUFFIX(fd_base58_encode)( unsigned char const * bytes,
      Initially, we don't require intermediate[i] < 58^5, but we do want
      to make sure the sums don't overflow. */
 
-  uint64_t intermediate[ INTERMEDIATE_SZ_W_PADDING ];
+  uint64_t intermediate[ INTERMEDIATE_SZ ];
+
+#if FD_HAS_IFMA
+
+  /* Each product binary[i]*enc52_table[i][j] is less than 2^52*58^5.
+     Its low 52 bits go to lo[j] and the rest to hi[j], so that
+       intermediate[j] = lo[j] + 2^52*hi[j]
+     with lo[j] < LIMB52_SZ*2^52 <= 2^55.4 and hi[j] < LIMB52_SZ*58^5
+     < 2^32.6.  Since 2^52 = 6861511*58^5 + 443814048, fold 2^52*hi[j]
+     into 443814048*hi[j] in column j and 6861511*hi[j] in column j-1.
+     That leaves every column below 2^62.1, with no mini-reduction. */
+
+  __m512i lo[ INTERMEDIATE_VEC_CNT ];
+  __m512i hi[ INTERMEDIATE_VEC_CNT ];
+  for( uint64_t k=0UL; k<INTERMEDIATE_VEC_CNT; k++ ) lo[ k ] = hi[ k ] = _mm512_setzero_si512();
+
+  for( uint64_t i=0UL; i<LIMB52_SZ; i++ ) {
+    __m512i b = _mm512_set1_epi64( (long long)binary[ i ] );
+    for( uint64_t k=0UL; k<INTERMEDIATE_VEC_CNT; k++ ) {
+      __m512i t = _mm512_load_si512( &TABLE(enc52_table)[ i ][ 8UL*k ] );
+      lo[ k ] = _mm512_madd52lo_epu64( lo[ k ], b, t );
+      hi[ k ] = _mm512_madd52hi_epu64( hi[ k ], b, t );
+    }
+  }
+
+  __m512i col[ INTERMEDIATE_VEC_CNT ];
+  for( uint64_t k=0UL; k<INTERMEDIATE_VEC_CNT; k++ ) {
+    __m512i hi_next = fd_base58_ifma_next_lane( hi[ k ], k+1UL<INTERMEDIATE_VEC_CNT ? hi[ k+1UL ] : _mm512_setzero_si512() );
+    col[ k ] = _mm512_add_epi64( _mm512_add_epi64( lo[ k ], _mm512_mullo_epi64( hi[ k ], _mm512_set1_epi64( 443814048L ) ) ),
+                                 _mm512_mullo_epi64( hi_next, _mm512_set1_epi64( 6861511L ) ) );
+  }
+
+  /* Make sure each term is less than 58^5, reducing all the columns at
+     once.  After the first round, every column is below 2^33, after
+     the second below 58^5+14, and after that only the rare ripple
+     carry remains.  Column 0 never carries out because X < 58^(5*
+     INTERMEDIATE_SZ). */
+
+  for(;;) {
+    __m512i q[ INTERMEDIATE_VEC_CNT ];
+    for( uint64_t k=0UL; k<INTERMEDIATE_VEC_CNT; k++ ) col[ k ] = fd_base58_avx512_divmod( col[ k ], q+k );
+    __mmask8 big = 0;
+    for( uint64_t k=0UL; k<INTERMEDIATE_VEC_CNT; k++ ) {
+      col[ k ] = _mm512_add_epi64( col[ k ], fd_base58_ifma_next_lane( q[ k ], k+1UL<INTERMEDIATE_VEC_CNT ? q[ k+1UL ] : _mm512_setzero_si512() ) );
+      big      = (__mmask8)( big | _mm512_cmpge_epu64_mask( col[ k ], _mm512_set1_epi64( (long long)R1div ) ) );
+    }
+    if( FD_LIKELY( !big ) ) break;
+  }
+
+  for( uint64_t k=0UL; k<INTERMEDIATE_VEC_CNT; k++ ) {
+    uint64_t rem = INTERMEDIATE_SZ-8UL*k;
+    _mm512_mask_storeu_epi64( intermediate+8UL*k, (__mmask8)( rem>=8UL ? 0xFFU : (1U<<rem)-1U ), col[ k ] );
+  }
+
+#elif FD_HAS_AVX
+
+  /* The same products as below (including the N==64 mini-reduction,
+     whose overflow analysis carries over unchanged), vectorized over
+     the columns of enc_table: acc[k] holds intermediate[4k+1..4k+4].
+     For N==64, there are 17 columns and the last one is done in tail. */
 
-  memset( intermediate, 0, INTERMEDIATE_SZ_W_PADDING * sizeof(uint64_t) );
+  __m256i  acc[ ENC_GRP_CNT ];
+# if N==64
+  uint64_t tail = 0UL;
+# endif
+  for( uint64_t k=0UL; k<ENC_GRP_CNT; k++ ) acc[ k ] = _mm256_setzero_si256();
+
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ ) {
+#   if N==64
+    if( i==8UL ) {
+      uint64_t t[ 4 ];
+      _mm256_storeu_si256( (__m256i *)t, acc[ 3 ] );
+      t[ 2 ] += t[ 3 ]/R1div; /* intermediate[ 15 ] */
+      t[ 3 ] %= R1div;        /* intermediate[ 16 ] */
+      acc[ 3 ] = _mm256_loadu_si256( (__m256i const *)t );
+    }
+    tail += (uint64_t)binary[ i ] * (uint64_t)TABLE(enc_table)[ i ][ 16 ];
+#   endif
+    __m256i b = _mm256_set1_epi64x( (long long)binary[ i ] );
+    for( uint64_t k=ENC_ROW_START( i )/4UL; k<ENC_GRP_CNT; k++ ) {
+      __m256i t = _mm256_cvtepu32_epi64( _mm_loadu_si128( (__m128i const *)&TABLE(enc_table)[ i ][ 4UL*k ] ) );
+      acc[ k ] = _mm256_add_epi64( acc[ k ], _mm256_mul_epu32( b, t ) );
+    }
+  }
+
+  intermediate[ 0 ] = 0UL;
+  for( uint64_t k=0UL; k<ENC_GRP_CNT; k++ ) _mm256_storeu_si256( (__m256i *)( intermediate+4UL*k+1UL ), acc[ k ] );
+# if N==64
+  intermediate[ 17 ] = tail;
+# endif
+
+#else
+
+  memset( intermediate, 0, INTERMEDIATE_SZ * sizeof(uint64_t) );
 
 # if N==32
 
@@ -67,8 +229,8 @@ SUFFIX(fd_base58_encode)( unsigned char const * bytes,
      intermediate[8] will be be just over 2^63, which is fine. */
 
   for( uint64_t i=0UL; i < BINARY_SZ; i++ )
-    for( uint64_t j=0UL; j < INTERMEDIATE_SZ-1UL; j++ )
-      intermediate[ j+1UL ] += (uint64_t)binary[ i ] * (uint64_t)SUFFIX(enc_table)[ i ][ j ];
+    for( uint64_t j=ENC_ROW_START( i ); j < INTERMEDIATE_SZ-1UL; j++ )
+      intermediate[ j+1UL ] += (uint64_t)binary[ i ] * (uint64_t)TABLE(enc_table)[ i ][ j ];
 
 # elif N==64
 
@@ -85,20 +247,22 @@ SUFFIX(fd_base58_encode)( unsigned char const * bytes,
      2^63.76, so no problems there. */
 
   for( uint64_t i=0UL; i < 8UL; i++ )
-    for( uint64_t j=0UL; j < INTERMEDIATE_SZ-1UL; j++ )
-      intermediate[ j+1UL ] += (uint64_t)binary[ i ] * (uint64_t)SUFFIX(enc_table)[ i ][ j ];
+    for( uint64_t j=ENC_ROW_START( i ); j < INTERMEDIATE_SZ-1UL; j++ )
+      intermediate[ j+1UL ] += (uint64_t)binary[ i ] * (uint64_t)TABLE(enc_table)[ i ][ j ];
   /* Mini-reduction */
   intermediate[ 15 ] += intermediate[ 16 ]/R1div;
   intermediate[ 16 ] %= R1div;
   /* Finish iterations */
   for( uint64_t i=8UL; i < BINARY_SZ; i++ )
-    for( uint64_t j=0UL; j < INTERMEDIATE_SZ-1UL; j++ )
-      intermediate[ j+1UL ] += (uint64_t)binary[ i ] * (uint64_t)SUFFIX(enc_table)[ i ][ j ];
+    for( uint64_t j=ENC_ROW_START( i ); j < INTERMEDIATE_SZ-1UL; j++ )
+      intermediate[ j+1UL ] += (uint64_t)binary[ i ] * (uint64_t)TABLE(enc_table)[ i ][ j ];
 
 # else
 # error "Add support for this N"
 # endif
 
+#endif
+
   /* Now we make sure each term is less than 58^5. Again, we have to be
      a bit careful of overflow.
 
@@ -110,18 +274,69 @@ SUFFIX(fd_base58_encode)( unsigned char const * bytes,
 
      For N==64, in the worst case, the biggest entry in intermediate at
      this point is 2^63.87, and in the worst case, we add (2^64-1)/58^5,
-     which is still about 2^63.87. */
+     which is still about 2^63.87.
+
+     The IFMA version has already done this above. */
 
+#if !FD_HAS_IFMA
   for( uint64_t i=INTERMEDIATE_SZ-1UL; i>0UL; i-- ) {
     intermediate[ i-1UL ] += (intermediate[ i ]/R1div);
     intermediate[ i     ] %= R1div;
   }
+#endif
 
   /* Convert intermediate form to base 58.  This form of conversion
      exposes tons of ILP, but it's more than the CPU can take advantage
      of.
        X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i) */
 
+#if FD_HAS_AVX
+
+  /* Pad with leading zeros to whole vectors of u32 lanes.  The padding
+     turns into leading zero digits in front of raw_base58.  The extra
+     space at the end is for the garbage written by
+     fd_base58_avx_intermediate_to_raw and for the 32-byte loads below. */
+
+# define PAD_SZ (INTERMEDIATE_SZ_W_PADDING-INTERMEDIATE_SZ)
+
+  uint32_t intermediate_w_padding[ INTERMEDIATE_SZ_W_PADDING ];
+  for( uint64_t i=0UL; i<PAD_SZ;          i++ ) intermediate_w_padding[ i        ] = 0U;
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) intermediate_w_padding[ PAD_SZ+i ] = (uint32_t)intermediate[ i ];
+
+  uint8_t raw_base58_w_padding[ 5UL*INTERMEDIATE_SZ_W_PADDING+32UL ];
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ_W_PADDING; i+=8UL )
+    fd_base58_avx_intermediate_to_raw( _mm256_loadu_si256( (__m256i const *)( intermediate_w_padding+i ) ),
+                                       raw_base58_w_padding+5UL*i );
+
+  uint8_t const * raw_base58 = raw_base58_w_padding + 5UL*PAD_SZ;
+
+# undef PAD_SZ
+
+  uint64_t raw_leading_0s = RAW58_SZ;
+  for( uint64_t off=0UL; off<RAW58_SZ; off+=32UL ) {
+    uint32_t nonzero = ~fd_base58_avx_zero_mask( _mm256_loadu_si256( (__m256i const *)( raw_base58+off ) ) );
+    if( RAW58_SZ-off<32UL ) nonzero &= (1U<<(RAW58_SZ-off))-1U;
+    if( nonzero ) { raw_leading_0s = off + (uint64_t)__builtin_ctz( nonzero ); break; }
+  }
+
+  /* See below for why raw_leading_0s >= in_leading_0s.  The output is
+     at least BYTE_CNT>=32 characters long, so it can be written with
+     32-byte stores, the last of which might overlap the previous one. */
+
+  uint64_t skip = raw_leading_0s - in_leading_0s;
+  uint64_t len  = RAW58_SZ - skip;
+  for( uint64_t off=0UL; off+32UL<len; off+=32UL )
+    _mm256_storeu_si256( (__m256i *)( out+off ),
+                         fd_base58_avx_raw_to_chars( _mm256_loadu_si256( (__m256i const *)( raw_base58+skip+off ) ) ) );
+  _mm256_storeu_si256( (__m256i *)( out+len-32UL ),
+                       fd_base58_avx_raw_to_chars( _mm256_loadu_si256( (__m256i const *)( raw_base58+skip+len-32UL ) ) ) );
+
+  out[ len ] = '\0';
+  if( opt_len ) *opt_len = (unsigned)len;
+  return out;
+
+#else
+
   uint8_t raw_base58[ RAW58_SZ ];
   for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++) {
     /* We know intermediate[ i ] < 58^5 < 2^32 for all i, so casting to
@@ -171,18 +386,263 @@ SUFFIX(fd_base58_encode)( unsigned char const * bytes,
   out[ RAW58_SZ-skip ] = '\0';
   if( opt_len ) *opt_len = (unsigned)(RAW58_SZ-skip);
   return out;
+
+#endif
 }
 
-uint8_t *
-SUFFIX(fd_base58_decode)( char const *    encoded,
-                          unsigned char * out ) {
+/* fd_base58_decode_core is the body of both decode kernels below.  The
+   input is the len characters at encoded (BYTE_CNT<=len<ENCODED_SZ()),
+   or the cstr at encoded if len is FD_BASE58_CSTR.  It is always
+   inlined, so that each kernel only keeps the front end it uses. */
+
+static inline __attribute__((always_inline)) uint8_t *
+SUFFIX(fd_base58_decode_core)( char const *    encoded,
+                               uint64_t        len,
+                               unsigned char * out ) {
+
+#if FD_HAS_AVX
+
+# define IN_VEC_CNT ((ENCODED_SZ()+31UL)/32UL)
+# define PAD_SZ     (INTERMEDIATE_SZ_W_PADDING-INTERMEDIATE_SZ)
+
+  /* X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i)
+
+     Prepend enough 0s to make it exactly RAW58_SZ characters, plus
+     PAD_SZ*5 more to make a whole number of vectors of intermediate
+     limbs.  Whatever follows the last character lands after the end of
+     raw_base58.  The front ends below validate the characters and store
+     their digits there, and count the leading '1's. */
+
+  uint8_t raw_base58_w_padding[ 5UL*INTERMEDIATE_SZ_W_PADDING+32UL*IN_VEC_CNT ];
+  for( uint64_t i=0UL; i<5UL*INTERMEDIATE_SZ_W_PADDING; i+=32UL )
+    _mm256_storeu_si256( (__m256i *)( raw_base58_w_padding+i ), _mm256_setzero_si256() );
+
+  uint8_t * raw_base58    = raw_base58_w_padding + 5UL*PAD_SZ;
+  uint64_t  leading_1_cnt = 0UL;
+
+  if( len!=FD_BASE58_CSTR ) {
+
+    /* Read the characters in place, as whole vectors from the start,
+       and if that leaves a partial one, the vector that ends at the
+       last character (len>=BYTE_CNT>=32, see the _len kernel below).
+       None of them reaches past encoded+len, so there is nothing to
+       mask: a '\0' among them isn't a base58 character, and that last
+       vector overlaps the others with the same digits. */
+
+    uint64_t full_cnt  = len/32UL;
+    uint64_t tail_sz   = len%32UL;
+    uint64_t prepend_0 = RAW58_SZ-len;
+
+    __m256i  in[ IN_VEC_CNT ];
+    uint32_t invalid = 0U;
+    for( uint64_t k=0UL; k<full_cnt; k++ ) {
+      in[ k ] = _mm256_loadu_si256( (__m256i const *)( encoded+32UL*k ) );
+      invalid |= fd_base58_avx_invalid_mask( in[ k ] );
+    }
+    __m256i tail = _mm256_loadu_si256( (__m256i const *)( encoded+len-32UL ) );
+    invalid |= fd_base58_avx_invalid_mask( tail );
+    if( FD_UNLIKELY( invalid ) ) return NULL;
+
+    for( uint64_t k=0UL; k<full_cnt; k++ )
+      _mm256_storeu_si256( (__m256i *)( raw_base58+prepend_0+32UL*k ), fd_base58_avx_chars_to_raw( in[ k ] ) );
+    _mm256_storeu_si256( (__m256i *)( raw_base58+RAW58_SZ-32UL ), fd_base58_avx_chars_to_raw( tail ) );
+
+    uint64_t k = 0UL;
+    for( ; k<full_cnt; k++ ) {
+      uint32_t not_1 = ~fd_base58_avx_eq_mask( in[ k ], '1' );
+      if( not_1 ) { leading_1_cnt += (uint64_t)__builtin_ctz( not_1 ); break; }
+      leading_1_cnt += 32UL;
+    }
+    if( k==full_cnt && tail_sz ) { /* all '1's so far, the rest of them are the top tail_sz lanes of tail */
+      uint32_t not_1 = ~fd_base58_avx_eq_mask( tail, '1' ) >> (32UL-tail_sz);
+      leading_1_cnt += not_1 ? (uint64_t)__builtin_ctz( not_1 ) : tail_sz;
+    }
+
+  } else {
+
+    /* Load the first ENCODED_SZ() characters (and then some) into
+       vectors.  Like strlen, this reads past the nul terminator as long
+       as that can't cross into another page.  Otherwise, copy into a
+       buffer first. */
+
+    __m256i in[ IN_VEC_CNT ];
+    if( FD_LIKELY( ((uintptr_t)encoded & 4095UL) <= 4096UL-32UL*IN_VEC_CNT ) ) {
+      for( uint64_t k=0UL; k<IN_VEC_CNT; k++ ) in[ k ] = _mm256_loadu_si256( (__m256i const *)( encoded+32UL*k ) );
+    } else {
+      char buf[ 32UL*IN_VEC_CNT ];
+      memset( buf, 0, sizeof(buf) );
+      for( uint64_t i=0UL; i<ENCODED_SZ() && encoded[ i ]; i++ ) buf[ i ] = encoded[ i ];
+      for( uint64_t k=0UL; k<IN_VEC_CNT; k++ ) in[ k ] = _mm256_loadu_si256( (__m256i const *)( buf+32UL*k ) );
+    }
+
+    /* Count characters before the nul terminator, and validate them. */
+
+    uint64_t char_cnt = ENCODED_SZ();
+    for( uint64_t k=0UL; k<IN_VEC_CNT; k++ ) {
+      uint32_t nul = fd_base58_avx_zero_mask( in[ k ] );
+      if( nul ) { char_cnt = 32UL*k + (uint64_t)__builtin_ctz( nul ); break; }
+    }
+
+    if( FD_UNLIKELY( char_cnt >= ENCODED_SZ() ) ) return NULL; /* too long */
+
+    for( uint64_t k=0UL; k<IN_VEC_CNT; k++ ) {
+      uint32_t invalid = fd_base58_avx_invalid_mask( in[ k ] );
+      if( char_cnt-32UL*k<32UL ) invalid &= (1U<<(char_cnt-32UL*k))-1U;
+      if( FD_UNLIKELY( invalid ) ) return NULL;
+      if( char_cnt-32UL*k<=32UL ) break;
+    }
+
+    uint64_t prepend_0 = RAW58_SZ-char_cnt;
+    for( uint64_t k=0UL; k<IN_VEC_CNT; k++ )
+      _mm256_storeu_si256( (__m256i *)( raw_base58+prepend_0+32UL*k ), fd_base58_avx_chars_to_raw( in[ k ] ) );
+
+    /* The nul terminator isn't a '1', so leading_1_cnt<=char_cnt. */
+
+    for( uint64_t k=0UL; k<IN_VEC_CNT; k++ ) {
+      uint32_t not_1 = ~fd_base58_avx_eq_mask( in[ k ], '1' );
+      if( not_1 ) { leading_1_cnt += (uint64_t)__builtin_ctz( not_1 ); break; }
+      leading_1_cnt += 32UL;
+    }
+  }
+
+  /* Convert to the intermediate format (base 58^5):
+       X = sum_i intermediate[i] * 58^(5*(INTERMEDIATE_SZ-1-i)) */
+
+  uint32_t intermediate_w_padding[ INTERMEDIATE_SZ_W_PADDING ];
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ_W_PADDING; i+=8UL )
+    _mm256_storeu_si256( (__m256i *)( intermediate_w_padding+i ),
+                         fd_base58_avx_raw_to_intermediate( raw_base58_w_padding+5UL*i ) );
 
-  /* Validate string and count characters before the nul terminator */
+  uint32_t const * intermediate = intermediate_w_padding + PAD_SZ;
+
+# if FD_HAS_IFMA
+
+  /* Using the table, convert to 52-bit limbs, vectorized over the
+     columns of the table.  The low 52 bits of each product
+     intermediate[i]*dec52_table[i][j] go to limb j and the rest to limb
+     j-1.  Each limb gets at most 2*INTERMEDIATE_SZ terms below 2^52,
+     so none of it comes close to overflowing. */
+
+  __m512i lo[ LIMB52_VEC_CNT ];
+  __m512i hi[ LIMB52_VEC_CNT ];
+  for( uint64_t k=0UL; k<LIMB52_VEC_CNT; k++ ) lo[ k ] = hi[ k ] = _mm512_setzero_si512();
+
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    __m512i m = _mm512_set1_epi64( (long long)intermediate[ i ] );
+    for( uint64_t k=0UL; k<LIMB52_VEC_CNT; k++ ) {
+      __m512i t = _mm512_load_si512( &TABLE(dec52_table)[ i ][ 8UL*k ] );
+      lo[ k ] = _mm512_madd52lo_epu64( lo[ k ], m, t );
+      hi[ k ] = _mm512_madd52hi_epu64( hi[ k ], m, t );
+    }
+  }
+
+  /* The high halves from limb 0 would go above the most significant
+     limb, so they have to be zero. */
+
+  if( FD_UNLIKELY( _mm_cvtsi128_si64( _mm512_castsi512_si128( hi[ 0 ] ) ) ) ) return NULL;
+
+  uint64_t binary[ 8UL*LIMB52_VEC_CNT ];
+  for( uint64_t k=0UL; k<LIMB52_VEC_CNT; k++ )
+    _mm512_storeu_si512( binary+8UL*k,
+                         _mm512_add_epi64( lo[ k ], fd_base58_ifma_next_lane( hi[ k ], k+1UL<LIMB52_VEC_CNT ? hi[ k+1UL ] : _mm512_setzero_si512() ) ) );
+
+  /* Make sure each term is less than 2^52 */
+
+  for( uint64_t i=LIMB52_SZ-1UL; i>0UL; i-- ) {
+    binary[ i-1UL ] += (binary[ i ] >> 52);
+    binary[ i     ] &= FD_BASE58_IFMA_MASK52;
+  }
+
+  /* The most significant limb only holds the top 8*BYTE_CNT-52*
+     (LIMB52_SZ-1) bits, anything above that doesn't fit in BYTE_CNT
+     bytes. */
+
+  if( FD_UNLIKELY( binary[ 0UL ] >> (8UL*BYTE_CNT-52UL*(LIMB52_SZ-1UL)) ) ) return NULL;
+
+  fd_base58_ifma_limbs52_to_bytes( binary, LIMB52_SZ, out, BYTE_CNT );
+
+  uint64_t out_zero_mask = 0UL;
+  for( uint64_t k=0UL; k<BYTE_CNT/32UL; k++ )
+    out_zero_mask |= (uint64_t)fd_base58_avx_zero_mask( _mm256_loadu_si256( (__m256i const *)( out+32UL*k ) ) ) << (32UL*k);
+
+# else
+
+  /* Using the table, convert to overcomplete base 2^32, vectorized
+     over the columns of the table.  The sums are the same as in the
+     scalar version, so the same overflow analysis applies. */
+
+  __m256i acc[ BINARY_SZ/4UL ];
+  for( uint64_t k=0UL; k<BINARY_SZ/4UL; k++ ) acc[ k ] = _mm256_setzero_si256();
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    __m256i m = _mm256_set1_epi64x( (long long)intermediate[ i ] );
+    for( uint64_t k=DEC_ROW_START( i )/4UL; k<BINARY_SZ/4UL; k++ ) {
+      __m256i t = _mm256_cvtepu32_epi64( _mm_loadu_si128( (__m128i const *)&TABLE(dec_table)[ i ][ 4UL*k ] ) );
+      acc[ k ] = _mm256_add_epi64( acc[ k ], _mm256_mul_epu32( m, t ) );
+    }
+  }
+
+  uint64_t binary[ BINARY_SZ ];
+  for( uint64_t k=0UL; k<BINARY_SZ/4UL; k++ ) _mm256_storeu_si256( (__m256i *)( binary+4UL*k ), acc[ k ] );
+
+  /* Make sure each term is less than 2^32 (see below for overflow) */
+
+  for( uint64_t i=BINARY_SZ-1UL; i>0UL; i-- ) {
+    binary[ i-1UL ] += (binary[i] >> 32);
+    binary[ i     ] &= 0xFFFFFFFFUL;
+  }
+
+  if( FD_UNLIKELY( binary[ 0UL ] > 0xFFFFFFFFUL ) ) return NULL;
+
+  /* Narrow to 32-bit terms, convert to big endian and count the
+     leading zero bytes of the output as we go. */
+
+  uint64_t out_zero_mask = 0UL;
+  for( uint64_t k=0UL; k<BINARY_SZ/8UL; k++ ) {
+    __m256i narrow = _mm256_setr_epi32( 0, 2, 4, 6, 1, 3, 5, 7 );
+    __m256i lo     = _mm256_permutevar8x32_epi32( _mm256_loadu_si256( (__m256i const *)( binary+8UL*k     ) ), narrow );
+    __m256i hi     = _mm256_permutevar8x32_epi32( _mm256_loadu_si256( (__m256i const *)( binary+8UL*k+4UL ) ), narrow );
+    __m256i o      = fd_base58_avx_bswap32( _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+    _mm256_storeu_si256( (__m256i *)( out+32UL*k ), o );
+    out_zero_mask |= (uint64_t)fd_base58_avx_zero_mask( o ) << (32UL*k);
+  }
+
+# endif
+
+  /* Make sure the encoded version has the same number of leading '1's
+     as the decoded version has leading 0s (counted by the front end). */
+
+  uint64_t out_nonzero      = ~out_zero_mask;
+  uint64_t leading_zero_cnt = FD_LIKELY( out_nonzero ) ? (uint64_t)__builtin_ctzll( out_nonzero ) : BYTE_CNT;
+
+  if( FD_UNLIKELY( leading_1_cnt!=leading_zero_cnt ) ) return NULL;
+  return out;
+
+# undef PAD_SZ
+# undef IN_VEC_CNT
+
+#else
+
+  /* X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i) */
+
+# if FD_HAS_X86
+
+  /* Validate the string and convert it to digits in one SSE2 pass (see
+     fd_base58_sse.h), with enough 0s prepended to make it exactly
+     RAW58_SZ characters. */
+
+  uint8_t  raw_base58[ RAW58_SZ+16UL ];
+  uint64_t char_cnt = fd_base58_sse_decode_raw( encoded, len, ENCODED_SZ(), raw_base58, RAW58_SZ );
+  if( FD_UNLIKELY( char_cnt==~0UL ) ) return NULL;
+
+# else
+
+  /* Validate string and count characters before the nul terminator (or
+     up to len, where a nul is an invalid character) */
 
   uint64_t char_cnt = 0UL;
-  for( ; char_cnt<ENCODED_SZ(); char_cnt++ ) {
+  for( ; char_cnt<ENCODED_SZ() && char_cnt!=len; char_cnt++ ) {
     char c = encoded[ char_cnt ];
-    if( !c ) break;
+    if( !c && len==FD_BASE58_CSTR ) break;
     /* If c<'1', this will underflow and idx will be huge */
     uint64_t idx = (uint64_t)(uint8_t)c - (uint64_t)BASE58_INVERSE_TABLE_OFFSET;
     idx = idx<BASE58_INVERSE_TABLE_SENTINEL ? idx : BASE58_INVERSE_TABLE_SENTINEL;
@@ -191,8 +651,6 @@ SUFFIX(fd_base58_decode)( char const *    encoded,
 
   if( FD_UNLIKELY( char_cnt == ENCODED_SZ() ) ) return NULL; /* too long */
 
-  /* X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i) */
-
   uint8_t raw_base58[ RAW58_SZ ];
 
   /* Prepend enough 0s to make it exactly RAW58_SZ characters */
@@ -201,6 +659,8 @@ SUFFIX(fd_base58_decode)( char const *    encoded,
   for( uint64_t j=0UL; j<RAW58_SZ; j++ )
     raw_base58[ j ] = (j<prepend_0) ? (uint8_t)0 : base58_inverse[ encoded[ j-prepend_0 ] - BASE58_INVERSE_TABLE_OFFSET ];
 
+# endif
+
   /* Convert to the intermediate format (base 58^5):
        X = sum_i intermediate[i] * 58^(5*(INTERMEDIATE_SZ-1-i)) */
 
@@ -224,12 +684,10 @@ SUFFIX(fd_base58_decode)( char const *    encoded,
      2^63.998.  Hanging in there, just by a thread! */
 
   uint64_t binary[ BINARY_SZ ];
-  for( uint64_t j=0UL; j<BINARY_SZ; j++ ) {
-    uint64_t acc=0UL;
-    for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ )
-      acc += (uint64_t)intermediate[ i ] * (uint64_t)SUFFIX(dec_table)[ i ][ j ];
-    binary[ j ] = acc;
-  }
+  memset( binary, 0, sizeof(binary) );
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ )
+    for( uint64_t j=DEC_ROW_START( i ); j<BINARY_SZ; j++ )
+      binary[ j ] += (uint64_t)intermediate[ i ] * (uint64_t)TABLE(dec_table)[ i ][ j ];
 
   /* Make sure each term is less than 2^32.
 
@@ -257,20 +715,52 @@ SUFFIX(fd_base58_decode)( char const *    encoded,
     out_as_uint[ i ] = __builtin_bswap32( (uint32_t)binary[ i ] );
   }
   /* Make sure the encoded version has the same number of leading '1's
-     as the decoded version has leading 0s. The check doesn't read past
-     the end of encoded, because '\0' != '1', so it will return NULL. */
+     as the decoded version has leading 0s.  The check doesn't read past
+     the last character. */
 
   uint64_t leading_zero_cnt = 0UL;
   for( ; leading_zero_cnt<BYTE_CNT; leading_zero_cnt++ ) {
     if( out[ leading_zero_cnt ] ) break;
-    if( FD_UNLIKELY( encoded[ leading_zero_cnt ] != '1' ) ) return NULL;
+    if( FD_UNLIKELY( leading_zero_cnt>=char_cnt || encoded[ leading_zero_cnt ] != '1' ) ) return NULL;
   }
-  if( FD_UNLIKELY( encoded[ leading_zero_cnt ] == '1' ) ) return NULL;
+  if( FD_UNLIKELY( leading_zero_cnt<char_cnt && encoded[ leading_zero_cnt ] == '1' ) ) return NULL;
   return out;
+
+#endif
+}
+
+uint8_t *
+SUFFIX(fd_base58_decode)( char const *    encoded,
+                          unsigned char * out ) {
+  return SUFFIX(fd_base58_decode_core)( encoded, FD_BASE58_CSTR, out );
+}
+
+uint8_t *
+SUFFIX_LEN(fd_base58_decode)( char const *    encoded,
+                              unsigned long   len,
+                              unsigned char * out ) {
+  if( FD_UNLIKELY( len>=ENCODED_SZ() ) ) return NULL; /* too long */
+
+  /* A valid input has a '1' per leading zero byte, and the k bytes
+     after those are at least 256^(k-1) >= 58^(k-1), which takes at
+     least k digits, so it has at least BYTE_CNT characters.  The front
+     ends count on that to read whole vectors in place. */
+
+  if( FD_UNLIKELY( len<BYTE_CNT ) ) return NULL;
+  return SUFFIX(fd_base58_decode_core)( encoded, len, out );
 }
 
+#undef INTERMEDIATE_VEC_CNT
+#undef LIMB52_VEC_CNT
+#undef LIMB52_SZ
+#undef ENC_GRP_CNT
+#undef INTERMEDIATE_SZ_W_PADDING
+#undef DEC_ROW_START
+#undef ENC_ROW_START
 #undef RAW58_SZ
 #undef ENCODED_SZ
+#undef TABLE
+#undef SUFFIX_LEN
 #undef SUFFIX
 
 #undef BINARY_SZ
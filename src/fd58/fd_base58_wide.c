@@ -0,0 +1,138 @@
+/* Scalar kernels on wide limbs, see fd_base58_wide_tmpl.h.  The wide
+   kernels only need a compiler with unsigned __int128, not any
+   particular CPU extension.  On x86-64, the adx kernels are the same
+   with BMI2/ADX carry chains. */
+
+#include "fd_base58_private.h"
+
+#if FD_HAS_X86
+#include "fd_base58_sse.h"
+#endif
+
+#if FD_HAS_INT128
+
+/* fd_base58_wide_divmod returns floor(x/58^10) and stores x mod 58^10
+   in *r.  x must be less than 2^128.
+
+   The high word is reduced first by a division by a constant, which
+   the compiler turns into a multiply.  The remaining 128/64 division
+   (whose quotient now fits in 64 bits) uses the precomputed reciprocal
+   of the divisor shifted to have its top bit set (Moller and Granlund,
+   "Improved division by invariant integers", algorithm 4), so there is
+   no division instruction in it either. */
+
+#define FD_BASE58_WIDE_D     430804206899405824UL  /* 58^10 */
+#define FD_BASE58_WIDE_SHIFT 5                     /* 58^10 has 59 significant bits */
+#define FD_BASE58_WIDE_DN    (FD_BASE58_WIDE_D<<FD_BASE58_WIDE_SHIFT)
+#define FD_BASE58_WIDE_V     6236914525665173804UL /* floor((2^128-1)/DN) - 2^64 */
+
+static inline unsigned __int128
+fd_base58_wide_divmod( unsigned __int128 x,
+                       uint64_t *        r ) {
+  uint64_t hi = (uint64_t)(x>>64);
+  uint64_t lo = (uint64_t) x;
+
+  uint64_t q_hi = hi / FD_BASE58_WIDE_D;
+  hi -= q_hi * FD_BASE58_WIDE_D;
+
+  uint64_t u1 = (hi<<FD_BASE58_WIDE_SHIFT) | (lo>>(64-FD_BASE58_WIDE_SHIFT));
+  uint64_t u0 =  lo<<FD_BASE58_WIDE_SHIFT;
+
+  unsigned __int128 p = (unsigned __int128)FD_BASE58_WIDE_V * u1;
+  p += ((unsigned __int128)(u1+1UL)<<64) | u0;
+  uint64_t q   = (uint64_t)(p>>64);
+  uint64_t rem = u0 - q*FD_BASE58_WIDE_DN;
+  if( rem>(uint64_t)p )                      { q--; rem += FD_BASE58_WIDE_DN; }
+  if( FD_UNLIKELY( rem>=FD_BASE58_WIDE_DN ) ) { q++; rem -= FD_BASE58_WIDE_DN; }
+
+  *r = rem>>FD_BASE58_WIDE_SHIFT;
+  return ((unsigned __int128)q_hi<<64) | q;
+}
+
+/* wide_enc_table_64 contains the unique values less than 58^10 such
+   that:
+     2^(64*(7-j)) = sum_k table[j][k]*58^(10*(7-k))
+   As in fd_base58.c, the first column (always zero) is left out. */
+
+static uint64_t const wide_enc_table_64[ 8 ][ 8 ] __attribute__((aligned(64))) = {
+  {      263923771111UL,  20112045626031166UL, 137102595725453023UL, 221694818504603890UL,  84945250354100648UL, 261263892501481787UL, 140473947544862810UL, 411023679516334080UL},
+  {                 0UL,         6163660667UL, 328259976845877429UL, 244691729930768805UL, 320221641840787585UL, 116038530634715384UL, 191538295968179321UL, 325617104046750720UL},
+  {                 0UL,                  0UL,          143945778UL, 427733230038510807UL, 351727640059673596UL, 345876403188153485UL, 392135561449020227UL, 278656880006927360UL},
+  {                 0UL,                  0UL,                  0UL,            3361701UL, 213833551265508894UL, 337347248484495170UL, 107655397653736526UL, 410936591272642560UL},
+  {                 0UL,                  0UL,                  0UL,                  0UL,              78508UL, 424183098509034391UL,  60064719638501231UL, 271142538549126144UL},
+  {                 0UL,                  0UL,                  0UL,                  0UL,                  0UL,               1833UL, 212963933380338069UL, 362044810117614592UL},
+  {                 0UL,                  0UL,                  0UL,                  0UL,                  0UL,                  0UL,                 42UL, 352967383934507008UL},
+  {                 0UL,                  0UL,                  0UL,                  0UL,                  0UL,                  0UL,                  0UL,                  1UL}
+};
+
+/* wide_dec_table_64 contains the unique values less than 2^64 such
+   that:
+     58^(10*(8-j)) = sum_k table[j][k]*2^(64*(7-k)) */
+
+static uint64_t const wide_dec_table_64[ 9 ][ 8 ] __attribute__((aligned(64))) = {
+  {             1632305UL,  8086479994275434649UL,  4396633761539813940UL,  8613194357821669313UL, 15364050843067225183UL,  7282612808155136104UL,  2875363893335621632UL,                    0UL},
+  {                   0UL,             69894212UL,  4461667618631532771UL,  5521691562417692615UL, 14998188598681965509UL, 11861583421552322296UL,  7299367199012644416UL,                    0UL},
+  {                   0UL,                    0UL,           2992822783UL,  1647649252173553675UL,   484379256567131913UL,  6215892364515380284UL, 15012212772605336115UL,  1152921504606846976UL},
+  {                   0UL,                    0UL,                    0UL,         128150642573UL, 13074037976871724815UL,  4356904513438163217UL, 18314096336038670560UL, 10674657016774918144UL},
+  {                   0UL,                    0UL,                    0UL,                    0UL,        5487323634679UL, 16325220124948996194UL, 13951105899053887347UL, 12709475907299966976UL},
+  {                   0UL,                    0UL,                    0UL,                    0UL,                    0UL,      234963477880320UL,  7879672379596901447UL,  2083661800854781952UL},
+  {                   0UL,                    0UL,                    0UL,                    0UL,                    0UL,                    0UL,    10060976828248712UL, 11146215920195600384UL},
+  {                   0UL,                    0UL,                    0UL,                    0UL,                    0UL,                    0UL,                    0UL,   430804206899405824UL},
+  {                   0UL,                    0UL,                    0UL,                    0UL,                    0UL,                    0UL,                    0UL,                    1UL}
+};
+
+/* As with enc_table_32 and dec_table_32, the N==32 tables are the
+   bottom right corners of the N==64 ones: [ 4 ][ 4 ] (encode) and
+   [ 5 ][ 4 ] (decode) from row 4, column 4.  fd_base58_wide_tmpl.h
+   indexes the N==64 tables directly rather than through a pointer into
+   the middle of a row, which GCC would see as out of bounds. */
+
+#define KERNEL wide
+
+#define N                32
+#define INTERMEDIATE_SZ (5UL) /* Computed by ceil(log_(58^10) (256^32-1)) */
+#define BINARY_SZ       ((uint64_t)N/8UL)
+
+#include "fd_base58_wide_tmpl.h"
+
+#define N                64
+#define INTERMEDIATE_SZ (9UL) /* Computed by ceil(log_(58^10) (256^64-1)) */
+#define BINARY_SZ       ((uint64_t)N/8UL)
+
+#include "fd_base58_wide_tmpl.h"
+
+#undef KERNEL
+
+#if FD_HAS_X86
+
+/* The same kernels with the table products done with mulx/adcx/adox.
+   The dispatch in fd_base58.c only calls them on CPUs that support
+   the extensions in FD_BASE58_ADX. */
+
+FD_BASE58_TARGET_PUSH( FD_BASE58_ADX )
+
+#include "fd_base58_adx.h"
+
+#define FD_HAS_ADX 1
+#define KERNEL     adx
+
+#define N                32
+#define INTERMEDIATE_SZ (5UL)
+#define BINARY_SZ       ((uint64_t)N/8UL)
+
+#include "fd_base58_wide_tmpl.h"
+
+#define N                64
+#define INTERMEDIATE_SZ (9UL)
+#define BINARY_SZ       ((uint64_t)N/8UL)
+
+#include "fd_base58_wide_tmpl.h"
+
+#undef KERNEL
+#undef FD_HAS_ADX
+
+FD_BASE58_TARGET_POP()
+
+#endif /* FD_HAS_X86 */
+
+#endif /* FD_HAS_INT128 */
@@ -0,0 +1,276 @@
+/* Declares conversion functions to/from base58 for a specific size of
+   binary data, like fd_base58_tmpl.h, but with wider limbs: 64-bit
+   binary limbs and base 58^10 intermediate limbs, with unsigned __int128
+   accumulators.  For N==32, this is a 4x4 (encode) and 5x4 (decode)
+   table product instead of 8x8 and 9x8, and for N==64 8x8 and 9x8
+   instead of 16x17 and 18x16.
+
+   To use this template, define:
+
+     N: the length of the binary data (in bytes) to convert.  N must be
+         32 or 64 in the current implementation.
+     INTERMEDIATE_SZ: ceil(log_(58^10) ( (256^N) - 1)).
+     BINARY_SZ: N/8.
+     KERNEL: the name of the kernel flavour, as in fd_base58_tmpl.h.
+
+   INTERMEDIATE_SZ and BINARY_SZ should expand to uint64_ts while N should
+   be an integer literal.
+
+   On x86-64, the decode front end uses the SSE2 helpers from
+   fd_base58_sse.h.  If FD_HAS_ADX is set, the decode table product
+   accumulates in base 2^64 directly with the mulx/adcx/adox chains from
+   fd_base58_adx.h, and the declared functions must only be called on
+   CPUs that support BMI2 and ADX.
+
+   Expects that wide_enc_table_64, wide_dec_table_64,
+   fd_base58_wide_divmod and FD_BASE58_ENCODED_N_SZ exist (substituting
+   the numeric value of N).  The N==32 tables are the bottom right
+   corners of the N==64 ones, so TABLE(s,i,j) indexes those directly,
+   offset by 8-BINARY_SZ rows and columns.
+
+   This file is safe for inclusion multiple times. */
+
+#define BYTE_CNT      ((uint64_t) N)
+#define SUFFIX(s)     FD_EXPAND_THEN_CONCAT4(s,_,N,FD_EXPAND_THEN_CONCAT2(_,KERNEL))
+#define SUFFIX_LEN(s) FD_EXPAND_THEN_CONCAT4(s,_,N,FD_EXPAND_THEN_CONCAT2(_len_,KERNEL))
+#define TABLE(s,i,j)  s##_64[ (i)+8UL-BINARY_SZ ][ (j)+8UL-BINARY_SZ ]
+#define ENCODED_SZ()  FD_EXPAND_THEN_CONCAT3(FD_BASE58_ENCODED_, N, _SZ)
+#define RAW58_SZ      (INTERMEDIATE_SZ*10UL)
+
+char *
+SUFFIX(fd_base58_encode)( unsigned char const * bytes,
+                          unsigned            * opt_len,
+                          char                * out ) {
+
+  /* Count leading zeros (needed for final output) */
+
+  uint64_t in_leading_0s = 0UL;
+  for( ; in_leading_0s<BYTE_CNT; in_leading_0s++ ) if( bytes[ in_leading_0s ] ) break;
+
+  /* X = sum_i bytes[i] * 2^(8*(BYTE_CNT-1-i)) */
+
+  /* Convert N to 64-bit limbs:
+     X = sum_i binary[i] * 2^(64*(BINARY_SZ-1-i)) */
+  uint64_t binary[ BINARY_SZ ];
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ ) {
+    uint64_t limb;
+    memcpy( &limb, &bytes[ i*sizeof(uint64_t) ], sizeof(uint64_t) );
+    binary[ i ] = __builtin_bswap64( limb );
+  }
+
+  /* Convert to the intermediate format:
+       X = sum_i intermediate[i] * 58^(10*(INTERMEDIATE_SZ-1-i))
+     Entries of the table left of the diagonal are zero, so skip them.
+     Each column gets at most BINARY_SZ terms less than 2^64*58^10, so
+     the sums are less than 2^125.6 even for N==64. */
+
+  unsigned __int128 intermediate[ INTERMEDIATE_SZ ];
+  memset( intermediate, 0, sizeof(intermediate) );
+
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ )
+    for( uint64_t j=i; j<INTERMEDIATE_SZ-1UL; j++ )
+      intermediate[ j+1UL ] += (unsigned __int128)binary[ i ] * TABLE(wide_enc_table,i,j);
+
+  /* Make sure each term is less than 58^10.  The carries are less than
+     2^128/58^10 < 2^70, so this doesn't overflow either. */
+
+  uint64_t digit[ INTERMEDIATE_SZ ];
+  for( uint64_t i=INTERMEDIATE_SZ-1UL; i>0UL; i-- )
+    intermediate[ i-1UL ] += fd_base58_wide_divmod( intermediate[ i ], &digit[ i ] );
+  digit[ 0 ] = (uint64_t)intermediate[ 0 ]; /* Less than 58^10 since X < 256^N */
+
+  /* Convert intermediate form to base 58, in two halves of 5 digits per
+     limb.
+       X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i) */
+
+  uint8_t raw_base58[ RAW58_SZ ];
+  for( uint64_t i=0UL; i<2UL*INTERMEDIATE_SZ; i++ ) {
+    uint32_t v = (i&1UL) ? (uint32_t)( digit[ i/2UL ] % 656356768UL ) : (uint32_t)( digit[ i/2UL ] / 656356768UL );
+    raw_base58[ 5UL*i+4UL ] = (uint8_t)((v/1U       )%58U);
+    raw_base58[ 5UL*i+3UL ] = (uint8_t)((v/58U      )%58U);
+    raw_base58[ 5UL*i+2UL ] = (uint8_t)((v/3364U    )%58U);
+    raw_base58[ 5UL*i+1UL ] = (uint8_t)((v/195112U  )%58U);
+    raw_base58[ 5UL*i+0UL ] = (uint8_t)( v/11316496U); /* We know this one is less than 58 */
+  }
+
+  /* Skip leading zeros as in fd_base58_tmpl.h.  RAW58_SZ is at least as
+     large as there, so raw_leading_0s >= in_leading_0s still holds. */
+
+  uint64_t raw_leading_0s = 0UL;
+  for( ; raw_leading_0s<RAW58_SZ; raw_leading_0s++ ) if( raw_base58[ raw_leading_0s ] ) break;
+
+  uint64_t skip = raw_leading_0s - in_leading_0s;
+  for( uint64_t i=0UL; i<RAW58_SZ-skip; i++ )  out[ i ] = base58_chars[ raw_base58[ skip+i ] ];
+
+  out[ RAW58_SZ-skip ] = '\0';
+  if( opt_len ) *opt_len = (unsigned)(RAW58_SZ-skip);
+  return out;
+}
+
+/* fd_base58_decode_core is the body of both decode kernels, as in
+   fd_base58_tmpl.h. */
+
+static inline __attribute__((always_inline)) uint8_t *
+SUFFIX(fd_base58_decode_core)( char const *    encoded,
+                               uint64_t        len,
+                               unsigned char * out ) {
+
+  /* X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i) */
+
+#if FD_HAS_X86
+
+  /* Validate the string and convert it to digits in one SSE2 pass (see
+     fd_base58_sse.h), with enough 0s prepended to make it exactly
+     RAW58_SZ characters. */
+
+  uint8_t  raw_base58[ RAW58_SZ+16UL ];
+  uint64_t char_cnt = fd_base58_sse_decode_raw( encoded, len, ENCODED_SZ(), raw_base58, RAW58_SZ );
+  if( FD_UNLIKELY( char_cnt==~0UL ) ) return NULL;
+
+#else
+
+  /* Validate string and count characters before the nul terminator (or
+     up to len, where a nul is an invalid character) */
+
+  uint64_t char_cnt = 0UL;
+  for( ; char_cnt<ENCODED_SZ() && char_cnt!=len; char_cnt++ ) {
+    char c = encoded[ char_cnt ];
+    if( !c && len==FD_BASE58_CSTR ) break;
+    /* If c<'1', this will underflow and idx will be huge */
+    uint64_t idx = (uint64_t)(uint8_t)c - (uint64_t)BASE58_INVERSE_TABLE_OFFSET;
+    idx = idx<BASE58_INVERSE_TABLE_SENTINEL ? idx : BASE58_INVERSE_TABLE_SENTINEL;
+    if( FD_UNLIKELY( base58_inverse[ idx ] == BASE58_INVALID_CHAR ) ) return NULL;
+  }
+
+  if( FD_UNLIKELY( char_cnt == ENCODED_SZ() ) ) return NULL; /* too long */
+
+  /* Prepend enough 0s to make it exactly RAW58_SZ characters */
+
+  uint8_t raw_base58[ RAW58_SZ ];
+  uint64_t prepend_0 = RAW58_SZ-char_cnt;
+  for( uint64_t j=0UL; j<RAW58_SZ; j++ )
+    raw_base58[ j ] = (j<prepend_0) ? (uint8_t)0 : base58_inverse[ encoded[ j-prepend_0 ] - BASE58_INVERSE_TABLE_OFFSET ];
+
+#endif
+
+  /* Convert to the intermediate format (base 58^10):
+       X = sum_i intermediate[i] * 58^(10*(INTERMEDIATE_SZ-1-i)) */
+
+  uint64_t intermediate[ INTERMEDIATE_SZ ];
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    uint32_t half[ 2 ];
+    for( uint64_t h=0UL; h<2UL; h++ ) {
+      uint8_t const * r = raw_base58 + 10UL*i + 5UL*h;
+      half[ h ] = (uint32_t)r[ 0 ] * 11316496U +
+                  (uint32_t)r[ 1 ] * 195112U   +
+                  (uint32_t)r[ 2 ] * 3364U     +
+                  (uint32_t)r[ 3 ] * 58U       +
+                  (uint32_t)r[ 4 ] * 1U;
+    }
+    intermediate[ i ] = (uint64_t)half[ 0 ] * 656356768UL + (uint64_t)half[ 1 ];
+  }
+
+#if FD_HAS_ADX
+
+  /* Using the table, accumulate X directly in base 2^64, with carries
+     propagated as we go, so there is no normalization pass.  acc[0] is
+     an extra word above the BINARY_SZ limbs of the result (X is less
+     than 2^(64*(BINARY_SZ+1)) by a wide margin).  Row i of the table
+     starts at column s=i*BINARY_SZ/INTERMEDIATE_SZ (see below), so the
+     products only touch acc[s..BINARY_SZ], and the carry out of acc[s]
+     is propagated separately. */
+
+  uint64_t acc[ BINARY_SZ+1UL ];
+  memset( acc, 0, sizeof(acc) );
+  _Pragma("GCC unroll 16")
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+    uint64_t s = i*BINARY_SZ/INTERMEDIATE_SZ;
+    uint64_t c = fd_base58_adx_mac( acc+s, &TABLE(wide_dec_table,i,s), intermediate[ i ], BINARY_SZ-s );
+    for( uint64_t k=s; FD_UNLIKELY( c ) && k>0UL; k-- ) {
+      acc[ k-1UL ] += c;
+      c = acc[ k-1UL ]<c;
+    }
+  }
+
+  /* If the extra word is nonzero, X doesn't fit in BYTE_CNT bytes. */
+
+  if( FD_UNLIKELY( acc[ 0 ] ) ) return NULL;
+
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ ) {
+    uint64_t limb = __builtin_bswap64( acc[ i+1UL ] );
+    memcpy( out+8UL*i, &limb, sizeof(uint64_t) );
+  }
+
+#else
+
+  /* Using the table, convert to overcomplete base 2^64.  Row i of the
+     table is 58^(10*(INTERMEDIATE_SZ-1-i)), so the entries left of
+     column i*BINARY_SZ/INTERMEDIATE_SZ are zero and get skipped.  Each
+     column gets at most INTERMEDIATE_SZ terms less than 58^10*2^64, so
+     the sums are less than 2^125.8. */
+
+  unsigned __int128 binary[ BINARY_SZ ];
+  memset( binary, 0, sizeof(binary) );
+  for( uint64_t i=0UL; i<INTERMEDIATE_SZ; i++ )
+    for( uint64_t j=i*BINARY_SZ/INTERMEDIATE_SZ; j<BINARY_SZ; j++ )
+      binary[ j ] += (unsigned __int128)intermediate[ i ] * TABLE(wide_dec_table,i,j);
+
+  /* Make sure each term is less than 2^64 */
+
+  for( uint64_t i=BINARY_SZ-1UL; i>0UL; i-- ) {
+    binary[ i-1UL ] += binary[ i ] >> 64;
+    binary[ i     ]  = (uint64_t)binary[ i ];
+  }
+
+  /* If the largest term is 2^64 or bigger, X doesn't fit in BYTE_CNT
+     bytes. */
+
+  if( FD_UNLIKELY( binary[ 0UL ] >> 64 ) ) return NULL;
+
+  /* Convert each term to big endian for the final output */
+
+  for( uint64_t i=0UL; i<BINARY_SZ; i++ ) {
+    uint64_t limb = __builtin_bswap64( (uint64_t)binary[ i ] );
+    memcpy( out+8UL*i, &limb, sizeof(uint64_t) );
+  }
+
+#endif
+
+  /* Make sure the encoded version has the same number of leading '1's
+     as the decoded version has leading 0s.  The check doesn't read past
+     the last character. */
+
+  uint64_t leading_zero_cnt = 0UL;
+  for( ; leading_zero_cnt<BYTE_CNT; leading_zero_cnt++ ) {
+    if( out[ leading_zero_cnt ] ) break;
+    if( FD_UNLIKELY( leading_zero_cnt>=char_cnt || encoded[ leading_zero_cnt ] != '1' ) ) return NULL;
+  }
+  if( FD_UNLIKELY( leading_zero_cnt<char_cnt && encoded[ leading_zero_cnt ] == '1' ) ) return NULL;
+  return out;
+}
+
+uint8_t *
+SUFFIX(fd_base58_decode)( char const *    encoded,
+                          unsigned char * out ) {
+  return SUFFIX(fd_base58_decode_core)( encoded, FD_BASE58_CSTR, out );
+}
+
+uint8_t *
+SUFFIX_LEN(fd_base58_decode)( char const *    encoded,
+                              unsigned long   len,
+                              unsigned char * out ) {
+  if( FD_UNLIKELY( len>=ENCODED_SZ() ) ) return NULL; /* too long */
+  if( FD_UNLIKELY( len<BYTE_CNT     ) ) return NULL; /* too short, see fd_base58_tmpl.h */
+  return SUFFIX(fd_base58_decode_core)( encoded, len, out );
+}
+
+#undef RAW58_SZ
+#undef ENCODED_SZ
+#undef TABLE
+#undef SUFFIX_LEN
+#undef SUFFIX
+
+#undef BINARY_SZ
+#undef BYTE_CNT
+#undef INTERMEDIATE_SZ
+#undef N
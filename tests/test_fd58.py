@@ -0,0 +1,680 @@
+"""Tests of the Python binding.  The kernels themselves are checked
+against a reference conversion by test_fd_base58.c."""
+
+import array
+import mmap
+import os
+import sys
+import threading
+
+import pytest
+
+import fd58
+
+THREAD_CNT = 8
+
+ALPHABET = b"123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"
+
+
+def ref_enc(data):
+    # The textbook conversion, for the expected results.
+    num = int.from_bytes(data, "big")
+    digits = b""
+    while num:
+        num, rem = divmod(num, 58)
+        digits = ALPHABET[rem:rem + 1] + digits
+    return b"1" * (len(data) - len(data.lstrip(b"\0"))) + digits
+
+
+def sample_keys(n, cnt=16):
+    # Zero, the maximum, leading zero bytes and random keys.
+    keys = [bytes(n), b"\xff" * n, bytes(5) + b"\x01" * (n - 5), b"\0" + b"\xff" * (n - 1)]
+    return keys + [os.urandom(n) for _ in range(cnt - len(keys))]
+
+
+# Buffer inputs (enc32, dec32 and the 64 byte versions)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_buffer_inputs(n):
+    enc = fd58.enc32 if n == 32 else fd58.enc64
+    dec = fd58.dec32 if n == 32 else fd58.dec64
+    for key in sample_keys(n):
+        expected = ref_enc(key)
+        padded = bytearray(b"x" + key + b"y")
+        for data in (key, bytearray(key), memoryview(key), memoryview(padded)[1:-1], array.array("B", key)):
+            assert enc(data) == expected
+        text = bytearray(b"x" + expected + b"y")
+        for encoded in (expected, bytearray(expected), memoryview(text)[1:-1], array.array("B", expected)):
+            assert dec(encoded) == key
+
+
+def test_buffer_inputs_mmap():
+    with mmap.mmap(-1, mmap.PAGESIZE) as m:
+        key = os.urandom(32)
+        m[:32] = key
+        encoded = ref_enc(key)
+        m[64:64 + len(encoded)] = encoded
+        view = memoryview(m)
+        try:
+            assert fd58.enc32(view[:32]) == encoded
+            assert fd58.dec32(view[64:64 + len(encoded)]) == key
+        finally:
+            view.release()
+
+
+def test_buffer_inputs_invalid():
+    for bad in (bytes(31), bytes(33), bytearray(64), memoryview(bytes(64))[:31]):
+        with pytest.raises(ValueError, match="Data length must be 32 bytes"):
+            fd58.enc32(bad)
+    with pytest.raises(ValueError, match="Data length must be 64 bytes"):
+        fd58.enc64(bytes(32))
+    with pytest.raises(BufferError):
+        fd58.enc32(memoryview(bytes(64))[::2])
+    with pytest.raises(BufferError):
+        fd58.dec32(memoryview(b"1" * 64)[::2])
+    for bad in (None, 32, [0] * 32):
+        with pytest.raises(TypeError):
+            fd58.enc32(bad)
+        with pytest.raises(TypeError):
+            fd58.dec32(bad)
+    with pytest.raises(ValueError, match="invalid character at offset 3"):
+        fd58.dec32(bytearray(b"111O" + b"1" * 28))
+
+
+# Slices (dec32_slice and dec64_slice)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_slice(n):
+    dec_slice = fd58.dec32_slice if n == 32 else fd58.dec64_slice
+    for key in sample_keys(n):
+        encoded = ref_enc(key)
+        # Valid characters on both sides, which must not be read.
+        buf = b"z" * 7 + encoded + b"2" * 9
+        for b in (buf, bytearray(buf), memoryview(buf), buf.decode()):
+            assert dec_slice(b, 7, len(encoded)) == key
+        assert dec_slice(encoded, 0, len(encoded)) == key  # up to the end
+    # A run of '1's longer than the slice: only n of them are zero.
+    assert dec_slice(b"1" * 100, 10, n) == bytes(n)
+
+
+def test_slice_bounds():
+    buf = b"1" * 40
+    for offset, length in ((-1, 32), (0, -1), (9, 32), (40, 1), (sys.maxsize, 1), (1, sys.maxsize)):
+        with pytest.raises(ValueError, match="Slice out of range"):
+            fd58.dec32_slice(buf, offset, length)
+        with pytest.raises(ValueError, match="Slice out of range"):
+            fd58.dec64_slice(buf, offset, length)
+    assert fd58.dec32_slice(buf, 8, 32) == bytes(32)
+    with pytest.raises(ValueError, match="leading '1's"):
+        fd58.dec32_slice(buf, 40, 0)
+    with pytest.raises(ValueError, match="invalid character at offset 2"):
+        fd58.dec32_slice(b"xx11O" + b"1" * 40, 2, 32)
+
+
+# Output buffers (enc32_into, dec32_into and the 64 byte versions)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_into(n):
+    enc_into = fd58.enc32_into if n == 32 else fd58.enc64_into
+    dec_into = fd58.dec32_into if n == 32 else fd58.dec64_into
+    for key in sample_keys(n):
+        expected = ref_enc(key)
+        out = bytearray(b"x" * 100)
+        assert enc_into(key, out, 3) == len(expected)
+        assert out == b"xxx" + expected + b"x" * (97 - len(expected))
+        assert enc_into(memoryview(key), out) == len(expected)
+        assert out[:len(expected)] == expected
+
+        out = bytearray(b"x" * (n + 5))
+        assert dec_into(expected, out, 5) == n
+        assert out == b"x" * 5 + key
+        assert dec_into(expected.decode(), memoryview(out)) == n
+        assert out[:n] == key
+
+
+def test_into_bounds():
+    key = b"\xff" * 32
+    length = len(ref_enc(key))
+    out = bytearray(length + 2)
+    assert fd58.enc32_into(key, out, 2) == length  # ends exactly at the end
+    with pytest.raises(ValueError, match="Output buffer too small"):
+        fd58.enc32_into(key, out, 3)
+    with pytest.raises(ValueError, match="Output buffer too small"):
+        fd58.dec32_into(b"1" * 32, bytearray(31))
+    with pytest.raises(ValueError, match="Output buffer too small"):
+        fd58.dec64_into(b"1" * 64, bytearray(64), 1)
+    for f, arg in ((fd58.enc32_into, key), (fd58.dec32_into, b"1" * 32)):
+        with pytest.raises(ValueError, match="Offset must not be negative"):
+            f(arg, bytearray(64), -1)
+        with pytest.raises(BufferError):
+            f(arg, bytes(64))
+
+
+def test_into_failure_leaves_out_alone():
+    out = bytearray(b"z" * 64)
+    with pytest.raises(ValueError, match="invalid character"):
+        fd58.dec32_into(b"O" * 32, out)
+    with pytest.raises(ValueError, match="Data length must be 32 bytes"):
+        fd58.enc32_into(bytes(31), out)
+    assert out == b"z" * 64
+
+
+# str in and out (enc32_str, and str inputs to the decoders)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_str(n):
+    enc_str = fd58.enc32_str if n == 32 else fd58.enc64_str
+    dec = fd58.dec32 if n == 32 else fd58.dec64
+    dec_slice = fd58.dec32_slice if n == 32 else fd58.dec64_slice
+
+    class Str(str):
+        pass
+
+    for key in sample_keys(n):
+        expected = ref_enc(key).decode()
+        encoded = enc_str(key)
+        assert type(encoded) is str and encoded == expected
+        assert encoded.isascii() and hash(encoded) == hash(expected)
+        assert enc_str(bytearray(key)) == expected
+        assert dec(encoded) == key
+        assert dec(Str(encoded)) == key
+        assert dec_slice("\x00" + encoded + "x", 1, len(encoded)) == key
+
+
+def test_str_invalid():
+    # A str that isn't ASCII is read through its UTF-8, so offsets count
+    # UTF-8 bytes.
+    for text, what in (("1" * 31 + "\u00e9", "invalid character at offset 31"),
+                       ("11\u00e9" + "1" * 30, "invalid character at offset 2"),
+                       ("1" * 32 + "\0", "invalid character at offset 32"),
+                       ("\u20ac" * 40, "too long at offset 44")):
+        with pytest.raises(ValueError, match=what):
+            fd58.dec32(text)
+    with pytest.raises(TypeError):
+        fd58.enc32_str("1" * 32)
+
+
+# Error codes (dec32_batch and dec64_batch, and the ValueErrors)
+
+def test_error_codes():
+    assert fd58.SUCCESS == 0
+    codes = {fd58.ERR_LEN, fd58.ERR_CHAR, fd58.ERR_OVERFLOW, fd58.ERR_LEADING_ONES}
+    assert len(codes) == 4 and all(c < 0 for c in codes)
+
+
+def invalid_items(n):
+    # (item, status, message) for each kind of invalid input.
+    max_len = 44 if n == 32 else 88
+    return [
+        ("1" * (max_len + 1), fd58.ERR_LEN, f"too long at offset {max_len}"),
+        (bytearray(b"2" * 200), fd58.ERR_LEN, f"too long at offset {max_len}"),
+        ("1" * 5 + "O" + "1" * (n - 6), fd58.ERR_CHAR, "invalid character at offset 5"),
+        (b"1" * (n - 1) + b"\0", fd58.ERR_CHAR, f"invalid character at offset {n - 1}"),
+        ("z" * max_len, fd58.ERR_OVERFLOW, "value too large"),
+        ("", fd58.ERR_LEADING_ONES, "leading '1's don't match"),
+        ("1" * (n + 1), fd58.ERR_LEADING_ONES, "leading '1's don't match"),
+        ("1" * (n - 1), fd58.ERR_LEADING_ONES, "leading '1's don't match"),
+    ]
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_errors(n):
+    dec = fd58.dec32 if n == 32 else fd58.dec64
+    for item, _, message in invalid_items(n):
+        with pytest.raises(ValueError, match=f"Failed to decode Base58: {message}"):
+            dec(item)
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_batch(n):
+    dec_batch = fd58.dec32_batch if n == 32 else fd58.dec64_batch
+    keys = sample_keys(n)
+    bad = invalid_items(n)
+    items = []
+    expected_data = b""
+    expected_status = []
+    for i, key in enumerate(keys):
+        encoded = ref_enc(key)
+        items.append((encoded, encoded.decode(), bytearray(encoded), memoryview(encoded))[i % 4])
+        expected_data += key
+        expected_status.append(fd58.SUCCESS)
+        item, status, _ = bad[i % len(bad)]
+        items.append(item)
+        expected_data += bytes(n)  # invalid items decode to zeros
+        expected_status.append(status)
+    data, status = dec_batch(items)
+    assert type(data) is bytes and data == expected_data
+    assert type(status) is array.array and status.typecode == "b"
+    assert list(status) == expected_status
+    # Any iterable, not just lists
+    assert dec_batch(iter(items)) == (data, status)
+    assert dec_batch([]) == (b"", array.array("b"))
+
+
+def test_batch_invalid_type():
+    with pytest.raises(TypeError):
+        fd58.dec32_batch(["1" * 32, 5])
+    with pytest.raises(TypeError):
+        fd58.dec32_batch(5)
+
+
+# Encoded lengths
+
+def length_boundaries(n):
+    # 58^k and 58^k-1 for every k that fits, where the length changes, plus
+    # leading zero bytes, which encode as '1's.
+    values = []
+    for k in range(1, 100):
+        p = 58 ** k
+        if p >= 256 ** n:
+            break
+        values += [p.to_bytes(n, "big"), (p - 1).to_bytes(n, "big")]
+    values += [bytes(n), bytes(n - 1) + b"\1", b"\xff" * n]
+    return values + sample_keys(n)
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_encoded_len(n):
+    encoded_len = fd58.encoded_len32 if n == 32 else fd58.encoded_len64
+    encoded_len_packed = fd58.encoded_len32_packed if n == 32 else fd58.encoded_len64_packed
+    values = length_boundaries(n)
+    for data in values:
+        assert encoded_len(data) == len(ref_enc(data))
+        assert encoded_len(bytearray(data)) == len(ref_enc(data))
+    total, lens = encoded_len_packed(b"".join(values))
+    assert type(lens) is array.array and lens.typecode == "B"
+    assert list(lens) == [len(ref_enc(data)) for data in values]
+    assert total == sum(lens)
+    assert encoded_len_packed(b"") == (0, array.array("B"))
+    with pytest.raises(ValueError, match=f"Data length must be {n} bytes"):
+        encoded_len(bytes(n - 1))
+    with pytest.raises(ValueError, match=f"multiple of {n} bytes"):
+        encoded_len_packed(bytes(n + 1))
+
+
+# Lists (enc*_many and dec*_many)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_many(n):
+    enc_many = fd58.enc32_many if n == 32 else fd58.enc64_many
+    dec_many = fd58.dec32_many if n == 32 else fd58.dec64_many
+    keys = length_boundaries(n)
+    encoded = [ref_enc(key) for key in keys]
+    assert enc_many(keys) == encoded
+    assert enc_many(bytearray(key) for key in keys) == encoded
+    assert enc_many(keys, as_str=True) == [e.decode() for e in encoded]
+    assert all(type(e) is str for e in enc_many(keys, as_str=True))
+    assert dec_many(encoded) == keys
+    assert dec_many(e.decode() for e in encoded) == keys
+    assert dec_many(memoryview(e) for e in encoded) == keys
+    assert enc_many([]) == [] and dec_many([]) == []
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_many_errors(n):
+    enc_many = fd58.enc32_many if n == 32 else fd58.enc64_many
+    dec_many = fd58.dec32_many if n == 32 else fd58.dec64_many
+    keys = sample_keys(n, 4)
+    with pytest.raises(ValueError, match=rf"Data length must be {n} bytes \(item 2\)"):
+        enc_many(keys[:2] + [bytes(n + 1)] + keys[2:])
+    with pytest.raises(TypeError):
+        enc_many(keys + [5])
+    encoded = [ref_enc(key) for key in keys]
+    for item, _, message in invalid_items(n):
+        with pytest.raises(ValueError, match=f"Failed to decode Base58 item 3: {message}"):
+            dec_many(encoded[:3] + [item] + encoded[3:])
+    with pytest.raises(TypeError):
+        dec_many(encoded + [5])
+
+
+# Packed slots (enc*_packed and dec*_packed)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_packed(n):
+    enc_packed = fd58.enc32_packed if n == 32 else fd58.enc64_packed
+    dec_packed = fd58.dec32_packed if n == 32 else fd58.dec64_packed
+    width = 44 if n == 32 else 88
+    # More than one chunk of the C conversions (64 slots)
+    keys = length_boundaries(n) * 3
+    slots, lens = enc_packed(b"".join(keys))
+    assert type(slots) is bytes and len(slots) == width * len(keys)
+    assert type(lens) is array.array and lens.typecode == "B"
+    for i, key in enumerate(keys):
+        encoded = ref_enc(key)
+        assert lens[i] == len(encoded)
+        assert slots[i * width:(i + 1) * width] == encoded.ljust(width, b"\0")
+    assert dec_packed(slots, lens) == b"".join(keys)
+    assert dec_packed(slots) == b"".join(keys)  # slots end at their first nul
+    assert dec_packed(bytearray(slots), bytes(lens)) == b"".join(keys)
+    assert enc_packed(b"") == (b"", array.array("B"))
+    assert dec_packed(b"") == b"" and dec_packed(b"", b"") == b""
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_packed_errors(n):
+    enc_packed = fd58.enc32_packed if n == 32 else fd58.enc64_packed
+    dec_packed = fd58.dec32_packed if n == 32 else fd58.dec64_packed
+    width = 44 if n == 32 else 88
+    keys = sample_keys(n, 70)
+    slots, lens = enc_packed(b"".join(keys))
+    with pytest.raises(ValueError, match=f"multiple of {n} bytes"):
+        enc_packed(bytes(n + 1))
+    with pytest.raises(ValueError, match=f"multiple of {width} bytes"):
+        dec_packed(slots[:-1])
+    with pytest.raises(ValueError, match=f"Expected 70 lengths, got 69"):
+        dec_packed(slots, lens[:-1])
+    with pytest.raises(ValueError, match=f"Expected 70 lengths, got 71"):
+        dec_packed(slots, lens + array.array("B", [0]))
+    # A length past the slot width, on the last slot so nothing follows it
+    bad_lens = array.array("B", lens)
+    bad_lens[-1] = 200
+    with pytest.raises(ValueError, match=f"item 69: too long at offset {width}"):
+        dec_packed(slots, bad_lens)
+    # A nul inside the given length
+    bad = bytearray(slots)
+    bad[66 * width + 3] = 0
+    with pytest.raises(ValueError, match="item 66: invalid character at offset 3"):
+        dec_packed(bad, lens)
+    # Without lens, that slot ends at the nul, which is too short
+    with pytest.raises(ValueError, match="item 66: leading '1's"):
+        dec_packed(bad)
+    bad = bytearray(slots)
+    bad[65 * width] = ord("l")
+    with pytest.raises(ValueError, match="item 65: invalid character at offset 0"):
+        dec_packed(bad)
+    with pytest.raises(ValueError, match="item 0: leading '1's"):
+        dec_packed(bytes(width))
+
+
+# NumPy arrays (enc*_array and dec*_array)
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_array(n):
+    np = pytest.importorskip("numpy")
+    enc_array = fd58.enc32_array if n == 32 else fd58.enc64_array
+    dec_array = fd58.dec32_array if n == 32 else fd58.dec64_array
+    width = 44 if n == 32 else 88
+    keys = length_boundaries(n)[:32]
+    encoded = [ref_enc(key) for key in keys]
+    a = np.frombuffer(b"".join(keys), np.uint8).reshape(len(keys), n)
+    s = enc_array(a)
+    assert s.dtype == f"S{width}" and s.shape == (len(keys),)
+    assert s.tolist() == encoded
+    assert (enc_array(a.view(f"V{n}")[:, 0]) == s).all()
+    # Non-contiguous inputs, and any leading shape
+    assert (enc_array(a[::2]) == s[::2]).all()
+    assert enc_array(a[:12].reshape(2, 6, n)).shape == (2, 6)
+    d = dec_array(s)
+    assert d.dtype == np.uint8 and d.shape == (len(keys), n)
+    assert (d == a).all()
+    assert (dec_array(s.reshape(-1, 2)) == a.reshape(-1, 2, n)).all()
+    assert (dec_array(s[::3]) == a[::3]).all()
+    # Other string widths (S50 for 32 bytes), and 'U'
+    assert (dec_array(s.astype(f"S{width + 6}")) == a).all()
+    assert (dec_array(s.astype(f"S{width + 1}")) == a).all()
+    assert (dec_array(s.astype("U")) == a).all()
+    assert enc_array(np.zeros((0, n), np.uint8)).shape == (0,)
+    assert dec_array(np.array([], f"S{width}")).shape == (0, n)
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_array_errors(n):
+    np = pytest.importorskip("numpy")
+    enc_array = fd58.enc32_array if n == 32 else fd58.enc64_array
+    dec_array = fd58.dec32_array if n == 32 else fd58.dec64_array
+    for bad in [np.zeros((3, n - 1), np.uint8), np.zeros((3, n), np.int16),
+                np.zeros(3, f"V{n - 1}"), np.zeros((), np.uint8), np.zeros(3, f"S{n}")]:
+        with pytest.raises(ValueError, match="Expected a uint8 array"):
+            enc_array(bad)
+    for bad in [np.zeros(3, np.int32), np.zeros((3, n), np.uint8)]:
+        with pytest.raises(ValueError, match="Expected an array of dtype 'S' or 'U'"):
+            dec_array(bad)
+    s = np.array([ref_enc(key) for key in sample_keys(n, 4)])
+    s[2] = s[2][:5] + b"0"
+    with pytest.raises(ValueError, match="item 2: invalid character at offset 5"):
+        dec_array(s)
+    with pytest.raises(ValueError, match="item 2: invalid character at offset 5"):
+        dec_array(s.reshape(2, 2))  # by flat index
+    with pytest.raises(ValueError, match="item 0: too long"):
+        dec_array(np.array(["2" * 100]))
+    with pytest.raises(ValueError):
+        dec_array(np.array(["\xe9" * 44]))
+
+
+# Arrow arrays (enc*_arrow and dec*_arrow), through pyarrow
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_arrow(n):
+    pa = pytest.importorskip("pyarrow")
+    enc_arrow = fd58.enc32_arrow if n == 32 else fd58.enc64_arrow
+    dec_arrow = fd58.dec32_arrow if n == 32 else fd58.dec64_arrow
+    # More than one chunk of the encoder (128 rows), with nulls
+    keys = [None if i % 7 == 3 else key for i, key in enumerate(length_boundaries(n) * 3)]
+    strs = [None if key is None else ref_enc(key).decode() for key in keys]
+    a = pa.array(keys, pa.binary(n))
+    col = enc_arrow(a)
+    assert len(col) == len(keys)
+    s = pa.array(col)
+    assert s.type == pa.utf8() and s.to_pylist() == strs
+    d = pa.array(dec_arrow(s))
+    assert d.type == pa.binary(n) and d.to_pylist() == keys
+    # A column can be imported more than once
+    assert pa.array(col).to_pylist() == strs
+    # Sliced arrays, at offsets that do and don't fall on a byte of the
+    # validity bitmap
+    for start in (8, 5):
+        assert pa.array(enc_arrow(a.slice(start, 20))).to_pylist() == strs[start:start + 20]
+        assert pa.array(dec_arrow(s.slice(start, 20))).to_pylist() == keys[start:start + 20]
+    # The other string types, and no nulls
+    for t in (pa.large_utf8(), pa.binary(), pa.large_binary()):
+        assert pa.array(dec_arrow(s.cast(t))).to_pylist() == keys
+    assert pa.array(dec_arrow(s.drop_null())).to_pylist() == [k for k in keys if k is not None]
+    assert pa.array(enc_arrow(pa.array([], pa.binary(n)))).to_pylist() == []
+    assert pa.array(dec_arrow(pa.array([], pa.utf8()))).to_pylist() == []
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_arrow_errors(n):
+    pa = pytest.importorskip("pyarrow")
+    enc_arrow = fd58.enc32_arrow if n == 32 else fd58.enc64_arrow
+    dec_arrow = fd58.dec32_arrow if n == 32 else fd58.dec64_arrow
+    for bad in (pa.array([bytes(n - 1)], pa.binary(n - 1)), pa.array([bytes(n)]), pa.array([1])):
+        with pytest.raises(ValueError, match=f"Expected a FixedSizeBinary\\({n}\\)"):
+            enc_arrow(bad)
+    for bad in (pa.array([bytes(n)], pa.binary(n)), pa.array([1])):
+        with pytest.raises(ValueError, match="Expected a Utf8"):
+            dec_arrow(bad)
+    with pytest.raises(TypeError):
+        dec_arrow([ref_enc(bytes(n))])
+    strs = [ref_enc(key).decode() for key in sample_keys(n, 4)]
+    strs[2] = strs[2][:5] + "0"
+    with pytest.raises(ValueError, match="item 2: invalid character at offset 5"):
+        dec_arrow(pa.array(strs))
+    with pytest.raises(ValueError, match="item 1: invalid character at offset 5"):
+        dec_arrow(pa.array(strs).slice(1))
+    # Rows whose offsets are out of order, which pyarrow doesn't check
+    data = pa.py_buffer("".join(strs[:2]).encode())
+    ends = [0, len(strs[0]), len(strs[0]) + len(strs[1])]
+    bad = pa.Array.from_buffers(pa.utf8(), 2, [None, pa.array([ends[1], ends[0], ends[2]], pa.int32()).buffers()[1], data])
+    with pytest.raises(ValueError, match="Offsets of row 0 are out of range"):
+        dec_arrow(bad)
+    bad = pa.Array.from_buffers(pa.large_utf8(), 2, [None, pa.array([0, ends[1], 0], pa.int64()).buffers()[1], data])
+    with pytest.raises(ValueError, match="Offsets of row 1 are out of range"):
+        dec_arrow(bad)
+
+
+# Offsets (dec*_offsets)
+
+def offsets_of(items, typecode):
+    offsets = array.array(typecode, [0])
+    for item in items:
+        offsets.append(offsets[-1] + len(item))
+    return offsets
+
+
+@pytest.mark.parametrize("n", [32, 64])
+@pytest.mark.parametrize("typecode", ["i", "q"])
+def test_offsets(n, typecode):
+    dec_offsets = fd58.dec32_offsets if n == 32 else fd58.dec64_offsets
+    keys = sample_keys(n)
+    rows = [ref_enc(key) for key in keys]
+    expected_status = [fd58.SUCCESS] * len(keys)
+    for i, (item, status, _) in enumerate(invalid_items(n)):
+        rows[2 * i + 1] = item.encode() if type(item) is str else bytes(item)
+        keys[2 * i + 1] = bytes(n)  # invalid rows decode to zeros
+        expected_status[2 * i + 1] = status
+    data = b"".join(rows)
+    offsets = offsets_of(rows, typecode)
+    out, status = dec_offsets(data, offsets)
+    assert type(out) is bytes and out == b"".join(keys)
+    assert list(status) == expected_status
+    assert dec_offsets(data.decode(), offsets) == (out, status)
+    assert dec_offsets(bytearray(data), memoryview(offsets)) == (out, status)
+    # Into a buffer of our own, which can be larger
+    buf = bytearray(b"x" * (len(out) + 3))
+    assert dec_offsets(data, offsets, buf) == (buf, status)
+    assert buf == out + b"xxx"
+    # Rows can be empty, and needn't cover all of data
+    offsets = array.array(typecode, [0, 0, len(rows[0]), len(rows[0])])
+    out, status = dec_offsets(data, offsets)
+    assert out == bytes(n) + keys[0] + bytes(n)
+    assert list(status) == [fd58.ERR_LEADING_ONES, fd58.SUCCESS, fd58.ERR_LEADING_ONES]
+    assert dec_offsets(data, array.array(typecode, [5])) == (b"", array.array("b"))
+
+
+@pytest.mark.parametrize("n", [32, 64])
+def test_offsets_errors(n):
+    dec_offsets = fd58.dec32_offsets if n == 32 else fd58.dec64_offsets
+    rows = [ref_enc(key) for key in sample_keys(n, 3)]
+    data = b"".join(rows)
+    offsets = offsets_of(rows, "i")
+    for bad, row in [([0, len(rows[0]), len(data) + 1, len(data)], 1),
+                     ([-1, len(rows[0]), len(data)], 0),
+                     ([0, len(rows[0]), 0, len(data)], 1)]:
+        with pytest.raises(ValueError, match=f"Offsets of row {row} are out of range"):
+            dec_offsets(data, array.array("q", bad))
+    for bad in (array.array("h", offsets), array.array("d", offsets), bytes(8)):
+        with pytest.raises(ValueError, match="Offsets must be int32 or int64"):
+            dec_offsets(data, bad)
+    for bad in (array.array("i"), array.array("q")):
+        with pytest.raises(ValueError, match="at least one element"):
+            dec_offsets(data, bad)
+    with pytest.raises(ValueError, match="Output buffer too small"):
+        dec_offsets(data, offsets, bytearray(3 * n - 1))
+    with pytest.raises(BufferError):
+        dec_offsets(data, offsets, bytes(3 * n))
+    with pytest.raises(TypeError):
+        dec_offsets(data, [0, len(data)])
+
+
+# Threads
+
+@pytest.fixture
+def fast_switching():
+    # Switch threads as often as possible, so that conversions running
+    # without the GIL overlap with the others.
+    prev = sys.getswitchinterval()
+    sys.setswitchinterval(1e-6)
+    yield
+    sys.setswitchinterval(prev)
+
+
+def run_threads(target, cnt=THREAD_CNT):
+    errors = []
+
+    def run(i):
+        try:
+            target(i)
+        except BaseException as e:  # reported on the main thread
+            errors.append(e)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(cnt)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    if errors:
+        raise errors[0]
+
+
+@pytest.mark.parametrize("release_gil", [False, True])
+def test_threads_single(fast_switching, release_gil):
+    # Many threads converting one key at a time, each checking its own
+    # results, with and without the GIL released around the kernels (and
+    # on a free-threaded build, without a GIL at all).
+    prev = fd58.set_release_gil(release_gil)
+    try:
+        def work(i):
+            keys32 = [os.urandom(32) for _ in range(200)]
+            keys64 = [os.urandom(64) for _ in range(200)]
+            for _ in range(5):
+                for k in keys32:
+                    assert fd58.dec32(fd58.enc32(k)) == k
+                    assert fd58.dec32(fd58.enc32_str(k)) == k
+                for k in keys64:
+                    assert fd58.dec64(fd58.enc64(k)) == k
+
+        run_threads(work)
+    finally:
+        fd58.set_release_gil(prev)
+
+
+@pytest.mark.parametrize("release_gil", [False, True])
+def test_threads_bulk(fast_switching, release_gil):
+    # The bulk conversions release the GIL for 16 items or more whatever
+    # set_release_gil says (see its docstring), so they always overlap.
+    prev = fd58.set_release_gil(release_gil)
+    try:
+        def work(i):
+            for cnt in (1, 15, 16, 100):
+                keys = [os.urandom(32) for _ in range(cnt)]
+                enc = fd58.enc32_many(keys)
+                assert enc == [fd58.enc32(k) for k in keys]
+                assert fd58.dec32_many(enc) == keys
+                data, status = fd58.dec32_batch(enc + ["O0"])
+                assert data[:32 * cnt] == b"".join(keys)
+                assert list(status) == [fd58.SUCCESS] * cnt + [fd58.ERR_CHAR]
+                keys = [os.urandom(64) for _ in range(cnt)]
+                assert fd58.dec64_many(fd58.enc64_many(keys)) == keys
+
+        run_threads(work)
+    finally:
+        fd58.set_release_gil(prev)
+
+
+def test_list_mutated_during_bulk(fast_switching):
+    # The bulk conversions release the GIL for 16 items or more.  Another
+    # thread replacing (and so freeing) the items of the list they were
+    # given meanwhile must not pull the data out from under the kernels.
+    keys = [os.urandom(32) for _ in range(64)]
+    encs = [fd58.enc32(k) for k in keys]
+    key_set = set(keys)
+    enc_set = set(encs)
+    lst = [bytes(bytearray(e)) for e in encs]
+    done = threading.Event()
+
+    def mutate():
+        i = 0
+        while not done.is_set():
+            # Fresh objects, so the ones they replace are freed.
+            j = i % len(encs)
+            lst[j % len(lst)] = encs[j].decode() if i & 1 else bytes(bytearray(encs[j]))
+            if i % 97 == 0:
+                lst[:] = [bytes(bytearray(e)) for e in encs[: 16 + i % 48]]
+            i += 1
+
+    t = threading.Thread(target=mutate)
+    t.start()
+    try:
+        for _ in range(2000):
+            for k in fd58.dec32_many(lst):
+                assert k in key_set
+            data, status = fd58.dec32_batch(lst)
+            assert not any(status)
+            for i in range(0, len(data), 32):
+                assert data[i:i + 32] in key_set
+            for e in fd58.enc32_many([fd58.dec32(e) for e in lst[:16]] * 2):
+                assert e in enc_set
+    finally:
+        done.set()
+        t.join()
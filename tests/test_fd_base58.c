@@ -0,0 +1,533 @@
+/* Differential test of the base58 kernels: every backend the CPU
+   supports, and the batch and packed conversions on top of them, are
+   checked against the naive big number conversions below on random
+   and edge case inputs, and the _ex decodes against the plain ones.
+   Build and run with `make test`, which compiles it with
+   AddressSanitizer, so reads past the documented bounds of an input
+   fail too. */
+
+#include "fd_base58.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(c) do {                                                          \
+    if( !(c) ) {                                                              \
+      fprintf( stderr, "FAIL: %s(%d): %s (backend %s)\n",                     \
+               __FILE__, __LINE__, #c, fd_base58_backend( -1 ) );             \
+      exit( 1 );                                                              \
+    }                                                                         \
+  } while(0)
+
+static char const alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/* Cstr inputs live in slots of SLOT_SZ zeroed bytes: the kernels may
+   read past the nul terminator, up to the widest vector load (128
+   bytes from the start, with AVX-512 and N==64). */
+
+#define SLOT_SZ (256UL)
+
+static unsigned long
+max_len( unsigned long n ) {
+  return n==32UL ? FD_BASE58_ENCODED_32_LEN : FD_BASE58_ENCODED_64_LEN;
+}
+
+static unsigned long rng_state = 0x9E3779B97F4A7C15UL;
+
+static unsigned long
+rng( void ) {
+  rng_state ^= rng_state<<13;
+  rng_state ^= rng_state>>7;
+  rng_state ^= rng_state<<17;
+  return rng_state;
+}
+
+/* ref_encode converts the n bytes at bytes to base58 by repeated
+   division, returning the length of the cstr at out. */
+
+static unsigned long
+ref_encode( unsigned char const * bytes,
+            unsigned long         n,
+            char *                out ) {
+  unsigned char num[ 64 ];
+  memcpy( num, bytes, n );
+  unsigned long zero_cnt = 0UL;
+  while( zero_cnt<n && !bytes[ zero_cnt ] ) zero_cnt++;
+
+  char          digits[ 128 ];
+  unsigned long digit_cnt = 0UL;
+  for( unsigned long start=zero_cnt; start<n; ) {
+    unsigned rem = 0U;
+    for( unsigned long i=start; i<n; i++ ) {
+      unsigned t = (rem<<8) | num[ i ];
+      num[ i ] = (unsigned char)(t/58U);
+      rem      = t%58U;
+    }
+    digits[ digit_cnt++ ] = alphabet[ rem ];
+    while( start<n && !num[ start ] ) start++;
+  }
+
+  unsigned long len = 0UL;
+  for( unsigned long i=0UL; i<zero_cnt;  i++ ) out[ len++ ] = '1';
+  for( unsigned long i=digit_cnt; i>0UL; i-- ) out[ len++ ] = digits[ i-1UL ];
+  out[ len ] = '\0';
+  return len;
+}
+
+/* ref_decode classifies the len characters at s the way
+   fd_base58_decode_{32,64}_ex documents, converting them a digit at a
+   time.  On success, the result is at out. */
+
+static int
+ref_decode( char const *    s,
+            unsigned long   len,
+            unsigned long   n,
+            unsigned char * out,
+            unsigned long * err_off ) {
+  *err_off = 0UL;
+  if( len>max_len( n ) ) { *err_off = max_len( n ); return FD_BASE58_ERR_LEN; }
+  for( unsigned long i=0UL; i<len; i++ )
+    if( !s[ i ] || !strchr( alphabet, s[ i ] ) ) { *err_off = i; return FD_BASE58_ERR_CHAR; }
+
+  unsigned char num[ 64 ] = { 0 };
+  for( unsigned long i=0UL; i<len; i++ ) {
+    unsigned carry = (unsigned)(strchr( alphabet, s[ i ] )-alphabet);
+    for( unsigned long j=n; j>0UL; j-- ) {
+      unsigned t = num[ j-1UL ]*58U + carry;
+      num[ j-1UL ] = (unsigned char)t;
+      carry        = t>>8;
+    }
+    if( carry ) return FD_BASE58_ERR_OVERFLOW;
+  }
+
+  unsigned long one_cnt  = 0UL; while( one_cnt<len && s[ one_cnt ]=='1' ) one_cnt++;
+  unsigned long zero_cnt = 0UL; while( zero_cnt<n && !num[ zero_cnt ]  ) zero_cnt++;
+  if( one_cnt!=zero_cnt ) return FD_BASE58_ERR_LEADING_ONES;
+
+  memcpy( out, num, n );
+  return FD_BASE58_SUCCESS;
+}
+
+static char *
+encode( unsigned long n, unsigned char const * bytes, unsigned * opt_len, char * out ) {
+  return n==32UL ? fd_base58_encode_32( bytes, opt_len, out ) : fd_base58_encode_64( bytes, opt_len, out );
+}
+
+static unsigned char *
+decode( unsigned long n, char const * encoded, unsigned char * out ) {
+  return n==32UL ? fd_base58_decode_32( encoded, out ) : fd_base58_decode_64( encoded, out );
+}
+
+static unsigned char *
+decode_len( unsigned long n, char const * encoded, unsigned long len, unsigned char * out ) {
+  return n==32UL ? fd_base58_decode_32_len( encoded, len, out ) : fd_base58_decode_64_len( encoded, len, out );
+}
+
+static int
+decode_ex( unsigned long n, char const * encoded, unsigned long len, unsigned char * out, unsigned long * err_off ) {
+  return n==32UL ? fd_base58_decode_32_ex( encoded, len, out, err_off ) : fd_base58_decode_64_ex( encoded, len, out, err_off );
+}
+
+/* check_encode checks the single encode of the n bytes at bytes, then
+   decodes the result back. */
+
+static void check_decode( unsigned long n, char const * s, unsigned long len );
+
+static void
+check_encode( unsigned long         n,
+              unsigned char const * bytes ) {
+  char          expected[ SLOT_SZ ];
+  unsigned long expected_len = ref_encode( bytes, n, expected );
+
+  char     out[ SLOT_SZ ];
+  unsigned len = ~0U;
+  memset( out, 'x', sizeof(out) );
+  TEST( encode( n, bytes, &len, out )==out );
+  TEST( len==expected_len );
+  TEST( !strcmp( out, expected ) );
+  TEST( encode( n, bytes, NULL, out )==out );
+  TEST( !strcmp( out, expected ) );
+
+  check_decode( n, expected, expected_len );
+}
+
+/* check_decode checks the single decodes of the len characters at s
+   (which may contain nuls) against ref_decode: the cstr kernel (when s
+   has no nul), the _len kernel on an exact size heap copy (so
+   AddressSanitizer catches any read past it) and _ex. */
+
+static void
+check_decode( unsigned long n,
+              char const *  s,
+              unsigned long len ) {
+  unsigned char expected[ 64 ];
+  unsigned long expected_off;
+  int           expected_err = ref_decode( s, len, n, expected, &expected_off );
+
+  unsigned char out[ 64 ];
+  if( !memchr( s, '\0', len ) ) {
+    char cstr[ SLOT_SZ ] = { 0 };
+    if( len<SLOT_SZ ) {
+      memcpy( cstr, s, len );
+      unsigned char * r = decode( n, cstr, out );
+      TEST( expected_err ? !r : r==out );
+      if( r ) TEST( !memcmp( out, expected, n ) );
+    }
+  }
+
+  char * copy = malloc( len ? len : 1UL );
+  TEST( copy );
+  memcpy( copy, s, len );
+
+  unsigned char * r = decode_len( n, copy, len, out );
+  TEST( expected_err ? !r : r==out );
+  if( r ) TEST( !memcmp( out, expected, n ) );
+
+  unsigned long off = ~0UL;
+  int           err = decode_ex( n, copy, len, out, &off );
+  TEST( err==expected_err );
+  if( !err ) TEST( !memcmp( out, expected, n ) );
+  else       TEST( off==expected_off );
+  TEST( decode_ex( n, copy, len, out, NULL )==expected_err );
+
+  free( copy );
+}
+
+/* check_encode_exact checks that the single encode of the n bytes at
+   bytes only writes encoded_len+1 bytes, as fd_base58.h promises (the
+   binding encodes straight into results of that size): it encodes into
+   a heap buffer of exactly that size, so AddressSanitizer catches any
+   store past it. */
+
+static void
+check_encode_exact( unsigned long         n,
+                    unsigned char const * bytes ) {
+  char          expected[ SLOT_SZ ] = { 0 };
+  unsigned long expected_len = ref_encode( bytes, n, expected );
+  unsigned long len = n==32UL ? fd_base58_encoded_len_32( bytes ) : fd_base58_encoded_len_64( bytes );
+  TEST( len==expected_len );
+
+  char * out = malloc( len+1UL );
+  TEST( out );
+  unsigned out_len = ~0U;
+  TEST( encode( n, bytes, &out_len, out )==out );
+  TEST( out_len==len );
+  TEST( !memcmp( out, expected, len+1UL ) );
+  free( out );
+}
+
+/* random_bytes fills the n bytes at bytes with a random number of
+   leading zeros, then random bytes, biased towards the extremes. */
+
+static void
+random_bytes( unsigned long   n,
+              unsigned char * bytes ) {
+  unsigned long zero_cnt = rng()%4UL ? rng()%4UL : rng()%(n+1UL);
+  for( unsigned long i=0UL; i<n; i++ ) {
+    unsigned long r = rng();
+    bytes[ i ] = i<zero_cnt ? 0 : (r&0x300UL)==0x300UL ? 0xFF : (unsigned char)r;
+  }
+}
+
+/* random_string stores a random string at s (not nul terminated) and
+   returns its length: mostly base58 characters, of lengths up to a
+   little past the maximum, sometimes with a bad one. */
+
+static unsigned long
+random_string( unsigned long n,
+               char *        s ) {
+  static char const bad[] = "0OIl+/ \x80\xff";
+  unsigned long len = rng()%(max_len( n )+4UL);
+  unsigned long one_cnt = rng()%2UL ? rng()%(len+1UL) : 0UL;
+  for( unsigned long i=0UL; i<len; i++ ) s[ i ] = i<one_cnt ? '1' : alphabet[ rng()%58UL ];
+  if( len && !(rng()%8UL) ) s[ rng()%len ] = bad[ rng()%(sizeof(bad)-1UL) ];
+  if( len && !(rng()%32UL) ) s[ rng()%len ] = '\0';
+  return len;
+}
+
+static void
+test_single( unsigned long n ) {
+  unsigned char bytes[ 64 ];
+  char          s[ SLOT_SZ ];
+
+  /* Edge cases: all zero, all 0xFF (the maximum value), and a single
+     bit at every position. */
+
+  memset( bytes, 0,    n ); check_encode( n, bytes );
+  memset( bytes, 0xFF, n ); check_encode( n, bytes );
+  for( unsigned long i=0UL; i<8UL*n; i++ ) {
+    memset( bytes, 0, n );
+    bytes[ i/8UL ] = (unsigned char)(1U<<(i%8UL));
+    check_encode( n, bytes );
+  }
+
+  for( unsigned long iter=0UL; iter<2000UL; iter++ ) {
+    random_bytes( n, bytes );
+    check_encode( n, bytes );
+    check_encode_exact( n, bytes );
+  }
+
+  /* Exact size outputs at every length boundary: 58^k-1 is the largest
+     number of k digits and 58^k the smallest of k+1, for every 58^k
+     that fits (and 0 and the maximum value). */
+
+  unsigned char pow[ 64 ] = { 0 };
+  pow[ n-1UL ] = 1;
+  for(;;) {
+    check_encode_exact( n, pow );
+    memcpy( bytes, pow, n );
+    for( unsigned long i=n; i>0UL && !bytes[ i-1UL ]--; i-- ) {} /* bytes = pow-1 */
+    check_encode_exact( n, bytes );
+
+    unsigned carry = 0U;
+    for( unsigned long i=n; i>0UL; i-- ) {
+      unsigned t = pow[ i-1UL ]*58U + carry;
+      pow[ i-1UL ] = (unsigned char)t;
+      carry        = t>>8;
+    }
+    if( carry ) break;
+  }
+  memset( bytes, 0,    n ); check_encode_exact( n, bytes );
+  memset( bytes, 0xFF, n ); check_encode_exact( n, bytes );
+
+  /* Every error class.  All '1's of every length: exactly n of them is
+     zero, fewer or more is a leading '1' mismatch (as is the empty
+     string), past the maximum length is too long. */
+
+  for( unsigned long len=0UL; len<=max_len( n )+2UL; len++ ) {
+    memset( s, '1', len );
+    check_decode( n, s, len );
+  }
+
+  /* The maximum value plus one overflows, as does a string of 'z's of
+     the maximum length. */
+
+  memset( bytes, 0xFF, n );
+  unsigned long len = ref_encode( bytes, n, s );
+  TEST( len==max_len( n ) );
+  for( unsigned long i=len; i>0UL; i-- ) {
+    char * c = strchr( alphabet, s[ i-1UL ] );
+    if( c[ 1 ] ) { s[ i-1UL ] = c[ 1 ]; break; }
+    s[ i-1UL ] = '1';
+  }
+  unsigned long off;
+  TEST( ref_decode( s, len, n, bytes, &off )==FD_BASE58_ERR_OVERFLOW );
+  check_decode( n, s, len );
+  memset( s, 'z', max_len( n ) );
+  check_decode( n, s, max_len( n ) );
+
+  /* Bad characters (including '\0') at every position of a valid
+     string, and valid strings with a character too many. */
+
+  static char const bad[] = "0OIl+/ \x80\xff";
+  for( unsigned long iter=0UL; iter<64UL; iter++ ) {
+    random_bytes( n, bytes );
+    len = ref_encode( bytes, n, s );
+    for( unsigned long i=0UL; i<len; i++ ) {
+      char c = s[ i ];
+      s[ i ] = bad[ (i+iter)%sizeof(bad) ]; /* includes the '\0' terminator of bad */
+      check_decode( n, s, len );
+      s[ i ] = c;
+    }
+    s[ len ] = alphabet[ rng()%58UL ];
+    check_decode( n, s, len+1UL );
+    memset( s+len, '1', max_len( n )+3UL-len );
+    check_decode( n, s, max_len( n )+3UL );
+  }
+
+  for( unsigned long iter=0UL; iter<20000UL; iter++ ) check_decode( n, s, random_string( n, s ) );
+}
+
+/* test_ex checks fd_base58_decode_{32,64}_ex against the plain decodes
+   on an input of each FD_BASE58_ERR_* class (and valid ones): _ex must
+   return the class and offset documented for it, and the cstr and _len
+   decodes must fail exactly when it does and otherwise produce the same
+   result. */
+
+static void
+check_ex( unsigned long n,
+          char const *  s,
+          unsigned long len,
+          int           expected_err,
+          unsigned long expected_off,
+          unsigned *    seen ) {
+  unsigned char ex_out[ 64 ];
+  unsigned long off = ~0UL;
+  int           err = decode_ex( n, s, len, ex_out, &off );
+  TEST( err==expected_err );
+  if( err ) TEST( off==expected_off );
+  *seen |= 1U<<(unsigned)(-err);
+
+  unsigned char out[ 64 ];
+  if( !memchr( s, '\0', len ) ) {
+    char cstr[ SLOT_SZ ] = { 0 };
+    memcpy( cstr, s, len );
+    unsigned char * r = decode( n, cstr, out );
+    TEST( err ? !r : r==out );
+    if( r ) TEST( !memcmp( out, ex_out, n ) );
+  }
+  unsigned char * r = decode_len( n, s, len, out );
+  TEST( err ? !r : r==out );
+  if( r ) TEST( !memcmp( out, ex_out, n ) );
+}
+
+static void
+test_ex( unsigned long n ) {
+  unsigned char bytes[ 64 ];
+  char          s[ SLOT_SZ ];
+  unsigned      seen = 0U;
+
+  /* Valid: zero (n '1's) and random numbers */
+
+  memset( s, '1', n ); check_ex( n, s, n, FD_BASE58_SUCCESS, 0UL, &seen );
+  for( unsigned long iter=0UL; iter<64UL; iter++ ) {
+    random_bytes( n, bytes );
+    check_ex( n, s, ref_encode( bytes, n, s ), FD_BASE58_SUCCESS, 0UL, &seen );
+  }
+
+  /* Too long: the offset is the first character past the maximum
+     length, whatever comes after it. */
+
+  memset( s, '1', max_len( n )+1UL ); check_ex( n, s, max_len( n )+1UL, FD_BASE58_ERR_LEN, max_len( n ), &seen );
+  memset( s, 'z', max_len( n )+5UL ); s[ 2 ] = 'O';
+  check_ex( n, s, max_len( n )+5UL, FD_BASE58_ERR_LEN, max_len( n ), &seen );
+
+  /* Bad characters: the offset is the first one. */
+
+  memset( bytes, 0xFF, n );
+  unsigned long len = ref_encode( bytes, n, s );
+  s[ 3 ] = 'O'; s[ 7 ] = '0';
+  check_ex( n, s, len, FD_BASE58_ERR_CHAR, 3UL, &seen );
+  s[ 0 ] = '\0';
+  check_ex( n, s, len, FD_BASE58_ERR_CHAR, 0UL, &seen );
+  memset( s, '1', n ); s[ n-1UL ] = '\xff';
+  check_ex( n, s, n, FD_BASE58_ERR_CHAR, n-1UL, &seen );
+
+  /* Too large a number */
+
+  memset( s, 'z', max_len( n ) ); check_ex( n, s, max_len( n ), FD_BASE58_ERR_OVERFLOW, 0UL, &seen );
+
+  /* Leading '1's that don't match the leading zero bytes: too few,
+     too many and none. */
+
+  check_ex( n, s, 0UL, FD_BASE58_ERR_LEADING_ONES, 0UL, &seen );
+  memset( s, '1', n+1UL );
+  check_ex( n, s, n-1UL, FD_BASE58_ERR_LEADING_ONES, 0UL, &seen );
+  check_ex( n, s, n+1UL, FD_BASE58_ERR_LEADING_ONES, 0UL, &seen );
+  memset( bytes, 0, n ); bytes[ n-1UL ] = 1;
+  len = ref_encode( bytes, n, s );
+  s[ len ] = '2';
+  check_ex( n, s+1, len, FD_BASE58_ERR_LEADING_ONES, 0UL, &seen );
+
+  TEST( seen==0x1FU );
+}
+
+/* test_batch checks the batch and packed conversions of cnt random
+   inputs against the single ones (checked above). */
+
+static void
+test_batch( unsigned long n,
+            unsigned long cnt ) {
+  unsigned long   sz      = n==32UL ? FD_BASE58_ENCODED_32_SZ : FD_BASE58_ENCODED_64_SZ;
+  unsigned long   width   = max_len( n );
+  unsigned char * bytes   = calloc( n*cnt+1UL, 1UL );
+  char *          out     = malloc( sz*cnt+1UL );
+  unsigned *      len     = malloc( sizeof(unsigned)*cnt+1UL );
+  char *          slots   = malloc( width*cnt+1UL );
+  unsigned char * lens    = malloc( cnt+1UL );
+  char *          strs    = calloc( cnt+1UL, SLOT_SZ );
+  char const **   ptrs    = malloc( sizeof(char const *)*cnt+1UL );
+  unsigned char * dec     = malloc( n*cnt+1UL );
+  unsigned char * valid   = malloc( cnt+1UL );
+  signed char *   errs    = malloc( cnt+1UL );
+  TEST( bytes && out && len && slots && lens && strs && ptrs && dec && valid && errs );
+
+  for( unsigned long i=0UL; i<cnt; i++ ) random_bytes( n, bytes+n*i );
+
+  /* Encode */
+
+  TEST( (n==32UL ? fd_base58_encode_32_batch : fd_base58_encode_64_batch)( bytes, cnt, len, out )==out );
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    char expected[ SLOT_SZ ] = { 0 };
+    TEST( len[ i ]==ref_encode( bytes+n*i, n, expected ) );
+    TEST( !strcmp( out+sz*i, expected ) );
+  }
+
+  TEST( (n==32UL ? fd_base58_encode_32_packed : fd_base58_encode_64_packed)( bytes, cnt, lens, slots )==slots );
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    TEST( lens[ i ]==len[ i ] );
+    TEST( !memcmp( slots+width*i, out+sz*i, len[ i ] ) );
+    for( unsigned long j=len[ i ]; j<width; j++ ) TEST( !slots[ width*i+j ] );
+  }
+
+  /* Decode a mix of valid and invalid strings */
+
+  unsigned long expected_cnt = 0UL;
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    char * s = strs+SLOT_SZ*i;
+    unsigned long l;
+    if( rng()%2UL ) { l = len[ i ]; memcpy( s, out+sz*i, l ); }
+    else            l = random_string( n, s );
+    l = l<width ? l : width; /* the slots are width wide */
+    memset( s+l, 0, SLOT_SZ-l );
+    ptrs[ i ] = s;
+    lens[ i ] = (unsigned char)strlen( s );
+    memset( slots+width*i, 0, width );
+    memcpy( slots+width*i, s, lens[ i ] );
+    unsigned char tmp[ 64 ];
+    unsigned long off;
+    expected_cnt += !ref_decode( s, lens[ i ], n, tmp, &off );
+  }
+
+  TEST( (n==32UL ? fd_base58_decode_32_batch : fd_base58_decode_64_batch)( ptrs, cnt, dec, valid )==expected_cnt );
+  for( unsigned long i=0UL; i<cnt; i++ ) {
+    unsigned char expected[ 64 ];
+    unsigned long off;
+    int           err = ref_decode( ptrs[ i ], lens[ i ], n, expected, &off );
+    TEST( valid[ i ]==!err );
+    if( !err ) TEST( !memcmp( dec+n*i, expected, n ) );
+  }
+
+  for( int with_lens=0; with_lens<2; with_lens++ ) {
+    memset( errs, 0x7F, cnt );
+    TEST( (n==32UL ? fd_base58_decode_32_packed : fd_base58_decode_64_packed)( slots, with_lens ? lens : NULL, cnt, dec, errs )==expected_cnt );
+    for( unsigned long i=0UL; i<cnt; i++ ) {
+      unsigned char expected[ 64 ];
+      unsigned long off;
+      int           err = ref_decode( ptrs[ i ], lens[ i ], n, expected, &off );
+      TEST( errs[ i ]==err );
+      if( err ) memset( expected, 0, n );
+      TEST( !memcmp( dec+n*i, expected, n ) );
+    }
+  }
+
+  free( bytes ); free( out ); free( len ); free( slots ); free( lens );
+  free( strs ); free( ptrs ); free( dec ); free( valid ); free( errs );
+}
+
+int
+main( void ) {
+  for( unsigned long idx=0UL; fd_base58_backend_name( idx ); idx++ ) {
+    char const * name = fd_base58_backend_name( idx );
+    TEST( !fd_base58_set_backend( name, -1 ) );
+    TEST( !strcmp( fd_base58_backend( -1 ), name ) );
+
+    test_single( 32UL );
+    test_single( 64UL );
+    test_ex( 32UL );
+    test_ex( 64UL );
+    for( unsigned long cnt=0UL; cnt<=20UL; cnt++ ) {
+      test_batch( 32UL, cnt );
+      test_batch( 64UL, cnt );
+    }
+    test_batch( 32UL, 1000UL );
+    test_batch( 64UL, 1000UL );
+
+    printf( "test_fd_base58: %s: pass\n", name );
+  }
+
+  TEST( !fd_base58_set_backend( "auto", -1 ) );
+  printf( "test_fd_base58: pass\n" );
+  return 0;
+}